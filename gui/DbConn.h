@@ -0,0 +1,188 @@
+/*
+DbConn.h
+========
+
+Gemeinsame Verbindungsverwaltung für die drei blockierenden DB-Klassen
+(Database in StatusPipeline.cpp, Database und FMDatabase in DVconfig).
+
+ - mysql_ping nur nach kIdlePingMs ohne Verkehr, nicht vor jedem Statement
+ - Verbindungsverlust wird am eigentlichen Statement erkannt (CR_SERVER_GONE_ERROR,
+   CR_SERVER_LOST): neu verbinden, onConnect (Schema + Prepared Statements) erneut
+   ausführen. Wiederholt wird die Operation genau einmal und nur bei CR_SERVER_GONE_ERROR;
+   nach CR_SERVER_LOST ist offen, ob der Server sie schon ausgeführt hat (INSERT doppelt)
+ - fehlgeschlagene Verbindungsversuche mit wachsendem Abstand (1 s … 30 s)
+ - Zähler für Pings, Wiederverbindungen, Wiederholungen und Verbindungsfehler
+
+AsyncDb (DVconfig, nicht blockierend) folgt derselben Regel und führt dieselben Zähler.
+
+MYSQL_OPT_RECONNECT bleibt aus: ein stiller Reconnect der Client-Bibliothek verliert
+die Transaktion und macht alle Prepared Statements ungültig, ohne dass es jemand merkt.
+Nicht threadsicher – jede Klasse hält ihre eigene Verbindung (FMDatabase mit Mutex).
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <mysql/mysql.h>
+#include <mysql/errmsg.h>
+
+class DbConn {
+public:
+    // Down: Server nicht erreichbar (auch nach dem Wiederholversuch) oder Verbindung während
+    // der Operation verloren – dann ist offen, ob sie ausgeführt wurde
+    enum class Result { Ok, Error, Down };
+
+    struct Settings {
+        std::string user = "mmdvm";
+        std::string pass;
+        std::string name = "mmdvmdb";
+        std::string unixSocket = "/run/mysqld/mysqld.sock";
+        // Ausgabe; Default: stderr mit tag davor
+        std::function<void(const std::string&)> log;
+        std::string tag = "[DB]";
+    };
+
+    struct Counters {
+        uint64_t pings = 0;
+        uint64_t reconnects = 0;      // erfolgreiche Verbindungen nach der ersten
+        uint64_t retries = 0;         // Operationen nach Verbindungsverlust wiederholt
+        uint64_t connectFailures = 0;
+    };
+
+    static constexpr int64_t kIdlePingMs = 60000;
+    static constexpr int64_t kRetryMinMs = 1000;
+    static constexpr int64_t kRetryMaxMs = 30000;
+
+    explicit DbConn(Settings s) : s_(std::move(s)) {
+        if (!s_.log) s_.log = [tag = s_.tag](const std::string& m) { std::fprintf(stderr, "%s %s\n", tag.c_str(), m.c_str()); };
+    }
+    ~DbConn() { close(); }
+
+    DbConn(const DbConn&) = delete;
+    DbConn& operator=(const DbConn&) = delete;
+
+    // Nach jedem Verbindungsaufbau (Schema, Statements vorbereiten); false = Verbindung verwerfen
+    void onConnect(std::function<bool(MYSQL*)> f) { onConnect_ = std::move(f); }
+    // Vor dem Schließen (Statements freigeben, solange die Verbindung noch existiert)
+    void onClose(std::function<void()> f) { onClose_ = std::move(f); }
+
+    // Verbundene Verbindung oder nullptr (Server weg bzw. Wartezeit bis zum nächsten Versuch)
+    MYSQL* get() {
+        const auto now = std::chrono::steady_clock::now();
+        if (conn_ && now - lastUse_ >= std::chrono::milliseconds(kIdlePingMs)) {
+            ++c_.pings;
+            if (mysql_ping(conn_) != 0) {
+                s_.log("ping after idle failed: " + std::string(mysql_error(conn_)) + " -> reconnect");
+                close();
+                retryAt_ = now;
+            }
+            lastUse_ = now;
+        }
+        if (!conn_ && now >= retryAt_) connect(now);
+        return conn_;
+    }
+
+    // op(MYSQL*) → bool. Bei Verbindungsverlust: neu verbinden und op einmal wiederholen,
+    // wenn sie den Server sicher nicht erreicht hat (retrySafe).
+    template <typename F>
+    Result run(F&& op) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            MYSQL* c = get();
+            if (!c) return Result::Down;
+            const bool ok = op(c);
+            lastUse_ = std::chrono::steady_clock::now();
+            if (ok) return Result::Ok;
+
+            const unsigned err = mysql_errno(c);
+            if (!isConnectionLost(err)) return Result::Error;
+            const bool retry = attempt == 0 && retrySafe(err);
+            s_.log("connection lost (" + std::to_string(err) + " " + mysql_error(c) + ")" +
+                   (retry ? " -> reconnect and retry" : attempt == 0 ? " -> reconnect, not retried" : ""));
+            close();
+            retryAt_ = lastUse_;   // sofort neu verbinden
+            if (!retry) break;
+            ++c_.retries;
+        }
+        return Result::Down;
+    }
+
+    void close() {
+        if (!conn_) return;
+        if (onClose_) onClose_();
+        mysql_close(conn_);
+        conn_ = nullptr;
+    }
+
+    static bool isConnectionLost(unsigned err) {
+        return err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST;
+    }
+    // Verbindung war schon vor dem Statement weg, es ist nicht gelaufen
+    static bool retrySafe(unsigned err) { return err == CR_SERVER_GONE_ERROR; }
+
+    const Counters& counters() const { return c_; }
+    std::string countersText() const { return countersText(c_); }
+    // auch für AsyncDb, das dieselben Zähler führt
+    static std::string countersText(const Counters& c) {
+        return "pings=" + std::to_string(c.pings) + " reconnects=" + std::to_string(c.reconnects) +
+               " retries=" + std::to_string(c.retries) + " connect_failures=" + std::to_string(c.connectFailures);
+    }
+    const std::string& lastError() const { return lastError_; }
+    const std::string& unixSocket() const { return s_.unixSocket; }
+
+private:
+    Settings s_;
+    MYSQL* conn_ = nullptr;
+    bool everConnected_ = false;
+    int64_t backoffMs_ = kRetryMinMs;
+    std::chrono::steady_clock::time_point lastUse_{};
+    std::chrono::steady_clock::time_point retryAt_{};
+    std::function<bool(MYSQL*)> onConnect_;
+    std::function<void()> onClose_;
+    Counters c_;
+    std::string lastError_;
+
+    bool connect(std::chrono::steady_clock::time_point now) {
+        conn_ = mysql_init(nullptr);
+        if (!conn_) {
+            lastError_ = "mysql_init failed";
+            return fail(now);
+        }
+        unsigned int proto = MYSQL_PROTOCOL_SOCKET;
+        mysql_options(conn_, MYSQL_OPT_PROTOCOL, &proto);
+
+        if (!mysql_real_connect(conn_, nullptr, s_.user.c_str(), s_.pass.c_str(), s_.name.c_str(),
+                                0, s_.unixSocket.c_str(), 0)) {
+            lastError_ = mysql_error(conn_);
+            mysql_close(conn_);
+            conn_ = nullptr;
+            return fail(now);
+        }
+        if (onConnect_ && !onConnect_(conn_)) {
+            lastError_ = mysql_error(conn_);
+            close();
+            return fail(now);
+        }
+
+        if (everConnected_) {
+            ++c_.reconnects;
+            s_.log("reconnected via unix_socket=" + s_.unixSocket + " (" + countersText() + ")");
+        }
+        everConnected_ = true;
+        backoffMs_ = kRetryMinMs;
+        lastError_.clear();
+        lastUse_ = now;
+        return true;
+    }
+
+    bool fail(std::chrono::steady_clock::time_point now) {
+        ++c_.connectFailures;
+        s_.log("connect failed: " + lastError_ + " (retry in " + std::to_string(backoffMs_) + " ms)");
+        retryAt_ = now + std::chrono::milliseconds(backoffMs_);
+        backoffMs_ = std::min(backoffMs_ * 2, kRetryMaxMs);
+        return false;
+    }
+};
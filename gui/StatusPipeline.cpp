@@ -0,0 +1,2678 @@
+/*
+StatusPipeline.cpp
+==================
+
+Implementierung zu StatusPipeline.h: Parser, Datenbank-Writer, Spool, Merger,
+Dateibeobachtung und -lesen, Import und Replay der Logdateien von MMDVMHost und den Gateways.
+*/
+
+#include "StatusPipeline.h"
+
+#include <fstream>
+#include <cerrno>
+#include <cstdlib>
+#include <charconv>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <filesystem>
+#include <unordered_set>
+#include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <zlib.h>          // zlib1g-dev
+
+namespace status {
+namespace {
+
+static inline std::optional<double> nullIfNaN(double v) {
+    return std::isnan(v) ? std::optional<double>{} : std::optional<double>{v};
+}
+
+static inline std::string trim(const std::string& s, bool strip_matching_quotes = false) {
+    // 1) Whitespace an beiden Seiten abschneiden (deine Logik)
+    size_t a = 0, b = s.size();
+    while (a < b && std::isspace((unsigned char)s[a])) ++a;
+    while (b > a && std::isspace((unsigned char)s[b-1])) --b;
+
+    std::string t = s.substr(a, b - a);
+
+    // 2) Optional: umschließende "…" oder '…' entfernen – nur wenn beide Seiten gleich sind
+    if (strip_matching_quotes && t.size() >= 2) {
+        char l = t.front();
+        char r = t.back();
+        if ((l == '"' && r == '"') || (l == '\'' && r == '\'')) {
+            t.erase(t.begin());         // vorne weg
+            t.pop_back();               // hinten weg
+        }
+    }
+    return t;
+}
+
+// Wie trim(), aber ohne Kopie
+static inline std::string_view trimView(std::string_view s) {
+    size_t a = 0, b = s.size();
+    while (a < b && std::isspace((unsigned char)s[a])) ++a;
+    while (b > a && std::isspace((unsigned char)s[b-1])) --b;
+    return s.substr(a, b - a);
+}
+
+struct FileId {
+    std::string path;
+    uint64_t inode = 0;
+    off_t size = 0;
+};
+
+static std::string utcDateStr() {
+    std::time_t tt = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&tt, &tm);  // <-- UTC!
+    std::ostringstream os;
+    os << std::put_time(&tm, "%Y-%m-%d");
+    return os.str();
+}
+
+static std::string localDateStr() {  // optional, als Fallback
+    std::time_t tt = std::time(nullptr);
+    std::tm tm{};
+    localtime_r(&tt, &tm);
+    std::ostringstream os;
+    os << std::put_time(&tm, "%Y-%m-%d");
+    return os.str();
+}
+
+static std::vector<std::string> logsForDir(const std::string& dir) {
+    const std::string utc = utcDateStr();
+    const std::string loc = localDateStr();
+    auto build = [&](const std::string& d){
+        return std::vector<std::string>{
+            (std::filesystem::path(dir)/("DMRGateway-"+d+".log")).string(),
+            (std::filesystem::path(dir)/("MMDVM-"+d+".log")).string(),
+            (std::filesystem::path(dir)/("YSFGateway-"+d+".log")).string()
+        };
+    };
+    auto utcSet = build(utc);
+    auto locSet = build(loc);
+
+    std::vector<std::string> out; out.reserve(3);
+    for (int i=0;i<3;++i) {
+        if (std::filesystem::exists(utcSet[i])) out.push_back(utcSet[i]);
+        else if (std::filesystem::exists(locSet[i])) out.push_back(locSet[i]);
+        else out.push_back(utcSet[i]); // fallback: UTC-Name beobachten
+    }
+    return out;
+}
+
+// Lesepositionen überleben einen Neustart des Rechners: StateDirectory= der systemd-Unit
+// (/var/lib/mmdvm-status), ohne Schreibrecht dort wie früher /tmp.
+static const char* kLegacyOffsetsPath = "/tmp/logparse.offsets";
+
+static std::string offsetsPath() {
+    static const std::string path = [] {
+        const char* env = std::getenv("STATE_DIRECTORY");
+        std::string base = (env && *env) ? std::string(env) : "/var/lib/mmdvm-status";
+        if (auto colon = base.find(':'); colon != std::string::npos) base.resize(colon); // mehrere Verzeichnisse
+        std::error_code ec;
+        std::filesystem::create_directories(base, ec);
+        if (ec || ::access(base.c_str(), W_OK) != 0) return std::string(kLegacyOffsetsPath);
+        return base + "/logparse.offsets";
+    }();
+    return path;
+}
+
+static std::map<std::string, OffsetEntry> loadOffsets() {
+    std::map<std::string, OffsetEntry> m;
+    std::ifstream in(offsetsPath());
+    if (!in) in.open(kLegacyOffsetsPath); // Übernahme vom alten Speicherort
+    if (!in) return m;
+    std::string path; uint64_t inode, offset;
+    while (in >> std::ws && std::getline(in, path)) {
+        if (path.rfind("#", 0) == 0 || path.empty()) continue; // Kommentare
+        // Format: <path>\t<inode>\t<offset>
+        std::istringstream ls(path);
+        std::string realPath; std::string inodeStr; std::string offStr;
+        if (std::getline(ls, realPath, '\t') &&
+            std::getline(ls, inodeStr, '\t') &&
+            std::getline(ls, offStr)) {
+            try {
+                inode = std::stoull(inodeStr);
+                offset = std::stoull(offStr);
+                m[realPath] = OffsetEntry{inode, offset};
+            } catch (...) {}
+        }
+    }
+    return m;
+}
+
+// Schreibt atomar: temporäre Datei, fsync, rename, fsync des Verzeichnisses.
+// Nach einem Absturz liegt damit immer entweder der alte oder der neue Stand vor.
+static bool saveOffsets(const std::map<std::string, OffsetEntry>& m) {
+    const std::string path = offsetsPath();
+    const std::string tmp = path + ".tmp";
+
+    std::string data;
+    for (const auto& [p, ent] : m) {
+        data += p;
+        data += '\t';
+        data += std::to_string(ent.inode);
+        data += '\t';
+        data += std::to_string(ent.offset);
+        data += '\n';
+    }
+
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) { dlog("[OFFS] open ", tmp, " failed: ", std::strerror(errno)); return false; }
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    const bool ok = done == data.size() && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(tmp.c_str(), path.c_str()) != 0) {
+        dlog("[OFFS] write ", path, " failed: ", std::strerror(errno));
+        ::unlink(tmp.c_str());
+        return false;
+    }
+
+    const std::string dir = std::filesystem::path(path).parent_path().string();
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) { ::fsync(dfd); ::close(dfd); }
+    return true;
+}
+
+static std::optional<FileId> statFile(const std::string& path) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return std::nullopt;
+    return FileId{path, static_cast<uint64_t>(st.st_ino), st.st_size};
+}
+
+static std::vector<std::string> defaultLogPaths() {
+    const std::string utc = utcDateStr();
+    const std::string loc = localDateStr();
+
+    // Kandidaten in Priorität: zuerst UTC, dann lokal
+    std::vector<std::vector<std::string>> candidates = {
+        {
+            "/var/log/mmdvm/DMRGateway-" + utc + ".log",
+            "/var/log/mmdvm/MMDVM-"      + utc + ".log",
+            "/var/log/mmdvm/YSFGateway-" + utc + ".log"
+        },
+        {
+            "/var/log/mmdvm/DMRGateway-" + loc + ".log",
+            "/var/log/mmdvm/MMDVM-"      + loc + ".log",
+            "/var/log/mmdvm/YSFGateway-" + loc + ".log"
+        }
+    };
+
+    std::vector<std::string> out;
+    out.reserve(3);
+    for (int i = 0; i < 3; ++i) {
+        // nimm den ersten existierenden Kandidaten je Rolle
+        std::string pick;
+        for (const auto& set : candidates) {
+            const std::string& p = set[i];
+            if (std::filesystem::exists(p)) { pick = p; break; }
+        }
+        // wenn keiner existiert, nimm UTC (wird später evtl. erscheinen)
+        if (pick.empty()) pick = candidates[0][i];
+        out.push_back(std::move(pick));
+    }
+    return out;
+}
+
+static inline bool starts_with(std::string_view s, const char* pfx) {
+    size_t n = std::strlen(pfx);
+    return s.size() >= n && std::memcmp(s.data(), pfx, n) == 0;
+}
+
+// ---- Zeilen-Scanner ----
+// Ersetzt die frühere std::regex-Kaskade: jede Zeile wird einmal anhand ihres
+// führenden Schlüsselworts ("Mode set to", "D-Star,", "YSF,", "DMR Slot") klassifiziert,
+// die Felder werden anschließend von Hand gelesen. Die Methoden bilden die Regex-Bausteine
+// nach (\s+, \S+, \d+, [\d.]+) und verschieben pos nur bei Erfolg.
+struct LineScanner {
+    std::string_view s;
+    size_t pos = 0;
+
+    static bool isWs(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    bool atEnd() const { return pos >= s.size(); }
+
+    // \s*
+    void optWs() { while (pos < s.size() && isWs(s[pos])) ++pos; }
+
+    // \s+
+    bool ws() {
+        size_t p = pos;
+        optWs();
+        return pos > p;
+    }
+
+    // exaktes Literal
+    bool lit(std::string_view w) {
+        if (s.substr(pos, w.size()) != w) return false;
+        pos += w.size();
+        return true;
+    }
+
+    // Wortfolge, Leerzeichen im Muster stehen für \s+ ("received network header")
+    bool phrase(std::string_view w) {
+        size_t save = pos;
+        while (!w.empty()) {
+            size_t sp = w.find(' ');
+            if (!lit(w.substr(0, sp))) { pos = save; return false; }
+            if (sp == std::string_view::npos) break;
+            if (!ws()) { pos = save; return false; }
+            w.remove_prefix(sp + 1);
+        }
+        return true;
+    }
+
+    // \S+
+    std::string_view token() {
+        size_t p = pos;
+        while (pos < s.size() && !isWs(s[pos])) ++pos;
+        return s.substr(p, pos - p);
+    }
+
+    // \d+
+    std::string_view digits() {
+        size_t p = pos;
+        while (pos < s.size() && isDigit(s[pos])) ++pos;
+        return s.substr(p, pos - p);
+    }
+
+    // [\d.]+
+    std::string_view number() {
+        size_t p = pos;
+        while (pos < s.size() && (isDigit(s[pos]) || s[pos] == '.')) ++pos;
+        return s.substr(p, pos - p);
+    }
+
+    // .*?<needle><rest> : probiert jedes Vorkommen von needle ab pos, bis rest() passt
+    template <typename F>
+    bool seekEach(std::string_view needle, F&& rest) {
+        size_t save = pos;
+        for (size_t at = s.find(needle, pos); at != std::string_view::npos; at = s.find(needle, at + 1)) {
+            pos = at + needle.size();
+            if (rest()) return true;
+        }
+        pos = save;
+        return false;
+    }
+};
+
+// Überspringt Schweregrad und Zeitstempel ("M: 2025-10-12 10:00:00.123 ") und
+// liefert den Meldungstext, an dessen Anfang das Schlüsselwort steht.
+static std::string_view messageBody(std::string_view line) {
+    size_t i = 0;
+    while (i < line.size() && LineScanner::isWs(line[i])) ++i;
+    if (i + 1 < line.size() && line[i] >= 'A' && line[i] <= 'Z' && line[i + 1] == ':') i += 2;
+    while (i < line.size() &&
+           (LineScanner::isWs(line[i]) || LineScanner::isDigit(line[i]) ||
+            line[i] == '-' || line[i] == ':' || line[i] == '.')) ++i;
+    return line.substr(i);
+}
+
+// ---- Bausteine des Parsers ----
+
+static uint8_t slotKey(const std::optional<int>& slot) {
+    return slot ? static_cast<uint8_t>(*slot) : 0;
+}
+
+static double toDouble(std::string_view v) {
+    double d = 0.0;
+    std::from_chars(v.data(), v.data() + v.size(), d);
+    return d;
+}
+
+// [A-Za-z0-9\-]
+static bool isModeChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || LineScanner::isDigit(c) || c == '-';
+}
+
+static int toInt(std::string_view v) {
+    int i = 0;
+    std::from_chars(v.data(), v.data() + v.size(), i);
+    return i;
+}
+
+// "\"...\"" mit mindestens einem Zeichen dazwischen
+static std::optional<std::string_view> quoted(LineScanner& sc) {
+    if (!sc.lit("\"")) return std::nullopt;
+    size_t q = sc.s.find('"', sc.pos);
+    if (q == std::string_view::npos || q == sc.pos) return std::nullopt;
+    std::string_view v = sc.s.substr(sc.pos, q - sc.pos);
+    sc.pos = q + 1;
+    return v;
+}
+
+// "Linked\s+to\s+<Rest der Zeile>" an beliebiger Stelle
+static std::optional<std::string_view> findLinkedTo(std::string_view line) {
+    LineScanner sc{line};
+    std::optional<std::string_view> out;
+    sc.seekEach("Linked", [&] {
+        if (!sc.ws() || !sc.lit("to")) return false;
+        size_t wsStart = sc.pos;
+        if (!sc.ws()) return false;
+        size_t end = line.find_first_of("\r\n", sc.pos);
+        if (end == std::string_view::npos) end = line.size();
+        // \s+ gibt notfalls ein Zeichen an den (nicht leeren) Rest ab
+        if (end == sc.pos) {
+            if (sc.pos - wsStart < 2 || line[sc.pos - 1] == '\r' || line[sc.pos - 1] == '\n') return false;
+            --sc.pos;
+        }
+        out = line.substr(sc.pos, end - sc.pos);
+        return true;
+    });
+    return out;
+}
+
+// "<Server>,\s+Logged into the master successfully" an beliebiger Stelle
+static std::optional<std::string_view> findMasterLogin(std::string_view line) {
+    LineScanner sc{line};
+    std::optional<std::string_view> out;
+    sc.seekEach("Logged", [&] {
+        size_t at = sc.pos - 6;
+        if (!sc.ws() || !sc.phrase("into the master successfully")) return false;
+        size_t p = at;
+        while (p > 0 && LineScanner::isWs(line[p - 1])) --p;
+        if (p == at || p == 0 || line[p - 1] != ',') return false;
+        size_t comma = p - 1, b = comma;
+        while (b > 0 && !LineScanner::isWs(line[b - 1])) --b;
+        if (b == comma) return false;
+        out = line.substr(b, comma - b);
+        return true;
+    });
+    return out;
+}
+
+// ",\s*<Sekunden>\s+seconds"
+static bool secondsField(LineScanner& sc, std::string_view& dur) {
+    if (!sc.lit(",")) return false;
+    sc.optWs();
+    dur = sc.number();
+    return !dur.empty() && sc.ws() && sc.lit("seconds");
+}
+
+// "BER:\s*<Wert>%"
+static bool berField(LineScanner& sc, std::string_view& ber) {
+    if (!sc.lit("BER:")) return false;
+    sc.optWs();
+    ber = sc.number();
+    return !ber.empty() && sc.lit("%");
+}
+
+// ".*?BER:\s*<Wert>%"
+static bool seekBer(LineScanner& sc, std::string_view& ber) {
+    return sc.seekEach("BER:", [&] { sc.pos -= 4; return berField(sc, ber); });
+}
+
+// Tage seit 1970-01-01 für ein gregorianisches Datum (days_from_civil nach H. Hinnant)
+static int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// n Ziffern ab p als Zahl, -1 wenn keine Ziffer
+static int fixedDigits(const char* p, int n) {
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!LineScanner::isDigit(p[i])) return -1;
+        v = v * 10 + (p[i] - '0');
+    }
+    return v;
+}
+
+// Erzwungenes Ende (Idle oder neuer Start auf derselben Session)
+static ParsedResult
+forcedEnd(const TransmissionState& open,
+          std::string_view line,
+          const std::optional<std::chrono::system_clock::time_point>& ts) {
+    ParsedResult res;
+    res.originalLine = line;
+    res.kind = EventKind::End;
+    res.mode = open.mode;
+    res.source = open.source;
+    res.callsign = open.callsign;
+    res.dgId = open.dgId;
+    res.slot = open.slot;
+
+    if (ts.has_value()) {
+        auto d = std::chrono::duration_cast<std::chrono::milliseconds>(ts.value() - open.startTp).count();
+        res.durationSec = d / 1000.0;
+    } else {
+        res.durationSec = std::nullopt;
+    }
+    res.berPct = std::nullopt; // nicht im Log
+    return res;
+}
+
+static void printResult(const ParsedResult& r) {
+    std::cout << "ZEILE:   " << r.originalLine << "\n";
+    std::cout << "ANALYSE: " << kindName(r.kind);
+
+    // Quelle/Mode nur ausgeben, wenn sinnvoll
+    if (r.source != Source::None) std::cout << ", " << sourceName(r.source);
+    std::cout << ", " << modeName(r.mode);
+
+    // Callsign/DG-ID nur wenn vorhanden/sinnvoll
+    if (r.callsign != 0)
+        std::cout << ", Callsign=" << callsigns().str(r.callsign);
+    if (r.dgId.has_value())  std::cout << ", DG-ID=" << *r.dgId;
+    if (r.slot.has_value())  std::cout << ", Slot="  << *r.slot;
+
+    // Dauer/BER wenn vorhanden
+    if (r.durationSec.has_value())
+        std::cout << ", Dauer[s]=" << fmtNum(*r.durationSec);
+    if (r.berPct.has_value())
+        std::cout << ", BER[%]=" << fmtNum(*r.berPct);
+
+    // Info-Text (z. B. Verlinkt zu DCS001 R)
+    if (r.kind == EventKind::Unlink) {
+        std::cout << ", Info=\"DISCONNECTED\"";
+    } else if (r.kind == EventKind::Link) {
+        std::string_view prefix;
+        switch (r.mode) {
+            case Mode::DStar: prefix = "Verlinkt zu "; break;
+            case Mode::YSF:   prefix = "Linked to "; break;
+            case Mode::DMR:   prefix = "Logged into master: "; break;
+            default: break;
+        }
+        std::cout << ", Info=\"" << prefix << r.info << "\"";
+    }
+
+    std::cout << "\n";
+}
+
+
+[[maybe_unused]] static void printStatus(const std::map<std::string, OffsetEntry>& offsets,
+                        const std::map<std::string, uint64_t>& lastReadCounts) {
+    std::cout << "\033[2K\r"; // Zeile löschen (TTY-freundlich)
+    std::cout.flush();
+
+    std::cout << "[STATUS] Watching " << offsets.size() << " log files: ";
+    bool first = true;
+    for (const auto& [path, off] : offsets) {
+        if (!first) std::cout << " | ";
+        std::cout << std::filesystem::path(path).filename().string();
+        first = false;
+    }
+
+    std::cout << "\n";
+
+    for (const auto& [path, count] : lastReadCounts) {
+        std::cout << "  " << std::filesystem::path(path).filename().string()
+                  << " +" << count << " lines" << std::endl;
+    }
+
+    std::cout.flush();
+}
+
+static std::string spoolPath() {
+    return (std::filesystem::path(offsetsPath()).parent_path() / "events.spool").string();
+}
+
+// Log-Dateien der G4KLX-Programme (auch die des nächsten Tages)
+static bool isLogName(std::string_view n) {
+    return starts_with(n, "MMDVM-") || starts_with(n, "YSFGateway-") || starts_with(n, "DMRGateway-");
+}
+
+} // namespace
+
+// ---- Ausgabe-Helfer ----
+std::string fmtNum(double v) {
+    // snprintf statt ostringstream: kurze Ergebnisse passen in den SSO-Puffer, keine Allokation
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.3f", v);
+    if (n < 0) return {};
+    size_t len = std::min(static_cast<size_t>(n), sizeof(buf) - 1);
+    if (std::memchr(buf, '.', len)) {
+        while (len > 0 && buf[len - 1] == '0') --len;
+        if (len > 0 && buf[len - 1] == '.') --len;
+    }
+    return std::string(buf, len);
+}
+
+Mode modeFromName(std::string_view s) {
+    for (Mode m : {Mode::Idle, Mode::DStar, Mode::DMR, Mode::YSF, Mode::P25, Mode::NXDN,
+                   Mode::POCSAG, Mode::FM, Mode::M17, Mode::Lockout, Mode::Error, Mode::Quit}) {
+        if (modeName(m) == s) return m;
+    }
+    return Mode::Unknown;
+}
+
+CallsignId CallsignTable::intern(std::string_view cs) {
+    if (cs.empty()) return 0;
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (auto it = index_.find(cs); it != index_.end()) return it->second;
+
+    const uint32_t id = count_.load(std::memory_order_relaxed);
+    if (id / kChunk >= kMaxChunks) return 0; // voll – praktisch unerreichbar
+    auto& chunk = chunks_[id / kChunk];
+    if (!chunk) chunk = std::make_unique<CallsignStr[]>(kChunk);
+    CallsignStr& slot = chunk[id % kChunk];
+    slot.assign(cs);
+    index_.emplace(slot.view(), id);
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+CallsignTable& callsigns() {
+    static CallsignTable t;
+    return t;
+}
+
+LocalConfig readLocalConfig() {
+    const std::string path = "/etc/MMDVMHost.ini";
+    std::ifstream f(path);
+    if (!f) {
+        dlog("[WARN] Kann ", path, " nicht öffnen – kein lokales Callsign/Duplex bekannt");
+        return {};
+    }
+
+    LocalConfig cfg;
+    std::string line;
+    while (std::getline(f, line)) {
+        // Kommentare/Leerzeilen überspringen
+        std::string raw = trim(line);
+        if (raw.empty() || raw[0] == '#' || raw[0] == ';' || raw[0] == '[') continue;
+
+        auto handle = [&](const char* key) -> std::optional<std::string> {
+            const size_t len = std::strlen(key);
+            if (raw.rfind(key, 0) == 0) {
+                return trim(raw.substr(len));
+            }
+            return std::nullopt;
+        };
+
+        if (auto v = handle("Callsign=")) {
+            if (cfg.callsign.empty()) {              // << nur erstes Vorkommen übernehmen
+                cfg.callsign = *v;
+                dlog("[INFO] Lokales Callsign erkannt: ", cfg.callsign);
+            }
+            continue;
+        }
+        if (auto v = handle("Duplex=")) {
+            try { cfg.duplex = std::stoi(*v); } catch (...) { cfg.duplex = 0; }
+            dlog("[INFO] Duplex aus INI: ", cfg.duplex);
+            continue;
+        }
+        if (auto v = handle("RXFrequency=")) {
+            try { cfg.rxFrequency = std::stoull(*v); } catch (...) { cfg.rxFrequency = 0; }
+            dlog("[INFO] RXFrequency: ", cfg.rxFrequency);
+            continue;
+        }
+        if (auto v = handle("TXFrequency=")) {
+            try { cfg.txFrequency = std::stoull(*v); } catch (...) { cfg.txFrequency = 0; }
+            dlog("[INFO] TXFrequency: ", cfg.txFrequency);
+            continue;
+        }
+        if (auto v = handle("Latitude=")) {
+            try { cfg.latitude = std::stod(*v); } catch (...) { cfg.latitude = std::numeric_limits<double>::quiet_NaN(); }
+            dlog("[INFO] Latitude: ", cfg.latitude);
+            continue;
+        }
+        if (auto v = handle("Longitude=")) {
+            try { cfg.longitude = std::stod(*v); } catch (...) { cfg.longitude = std::numeric_limits<double>::quiet_NaN(); }
+            dlog("[INFO] Longitude: ", cfg.longitude);
+            continue;
+        }
+        if (auto v = handle("Location=")) {
+            cfg.location = trim(*v, true);
+            dlog("[INFO] Location: ", cfg.location);
+            continue;
+        }
+        if (auto v = handle("Description=")) {
+            cfg.description = trim(*v, true);
+            dlog("[INFO] Description: ", cfg.description);
+            continue;
+        }
+    }
+
+    if (cfg.callsign.empty())
+        dlog("[WARN] Kein Callsign= in ", path, " gefunden");
+    return cfg;
+}
+
+bool isValidCallsign(std::string_view cs) {
+    if (cs.size() < 3) return false;  // zu kurz
+    int letters = 0, digits = 0;
+    for (char c : cs) {
+        if (std::isalpha(static_cast<unsigned char>(c))) ++letters;
+        if (std::isdigit(static_cast<unsigned char>(c))) ++digits;
+    }
+    return (letters >= 2 && digits >= 1);
+}
+
+// ---- LogParser ----
+
+std::optional<ParsedResult> LogParser::processLine(std::string_view line, StreamId stream) {
+    stream_ = stream;
+    const auto ts = extractTimestamp(line);
+    const size_t pendingBefore = pending_.size();
+
+    auto res = parseLine(line, ts);
+
+    // Ergebnis und erzwungene Enden tragen die Zeit der auslösenden Zeile
+    const auto when = ts.value_or(std::chrono::system_clock::now());
+    for (size_t i = pendingBefore; i < pending_.size(); ++i) pending_[i].ts = when;
+    if (res) res->ts = when;
+    return res;
+}
+
+std::string_view LogParser::sanitizeCallsign(std::string_view in) {
+    std::string_view s = trimView(in);
+    size_t p = s.find_first_of("/ ");
+    if (p != std::string_view::npos) s = s.substr(0, p);
+    return s;
+}
+
+std::optional<ParsedResult> LogParser::parseLine(std::string_view line, const std::optional<TimePoint>& ts) {
+    const std::string_view body = messageBody(line);
+
+    if (auto res = parseHead(line, ts, body)) return res;
+
+    // Gateway-Meldungen stehen nicht immer am Zeilenanfang ("XLX, Linked to ...",
+    // "<Server>, Logged into ..."), daher hier gezielte Suche statt Schlüsselwort.
+
+    // 2) YSF: "Linked to <Reflector>"
+    if (auto target = findLinkedTo(line)) {
+        ParsedResult res;
+        res.originalLine = line;
+        res.kind = EventKind::Link;
+        res.mode = Mode::YSF;
+        res.info = *target;   // z. B. "DE-C4FM-Germany"
+        return res;
+    }
+
+    // Disconnect-Meldungen als Info erzeugen
+    if (line.find("Disconnect by remote command") != std::string::npos ||
+        line.find("Closing YSF network connection") != std::string::npos) {
+
+        ParsedResult res;
+        res.originalLine = line;
+        res.kind = EventKind::Unlink;
+        res.mode = Mode::YSF;
+        return res;
+    }
+
+    // 3) DMR: "<ServerName>, Logged into the master successfully"
+    if (auto server = findMasterLogin(line)) {
+        ParsedResult res;
+        res.originalLine = line;
+        res.kind = EventKind::Link;
+        res.mode = Mode::DMR;
+        res.info = *server; // z. B. "BM_2621_Germany"
+        return res;
+    }
+
+    if (auto res = parseTransmission(line, ts, body)) return res;
+    return parseElsewhere(line, ts, body);
+}
+
+// Betriebsart und D-Star-Linktext; body beginnt beim Schlüsselwort
+std::optional<ParsedResult> LogParser::parseHead(std::string_view line, const std::optional<TimePoint>& ts,
+                                                std::string_view body) {
+    const char first = body.empty() ? '\0' : body.front();
+
+    // Betriebsart-Wechsel ("Mode set to <Mode>")
+    if (first == 'M') {
+        LineScanner sc{body};
+        if (sc.phrase("Mode set to") && sc.ws()) {
+            size_t p = sc.pos;
+            while (!sc.atEnd() && isModeChar(body[sc.pos])) ++sc.pos;
+            if (sc.pos > p) {
+                const Mode newMode = modeFromName(body.substr(p, sc.pos - p));
+
+                // Wenn Idle → offene QSOs dieser Logdatei erzwingen wir hier zu beenden
+                // (erst die erzwungenen Enden ausgeben lassen)
+                if (newMode == Mode::Idle) endStreamSessions(line, ts);
+
+                // Eigenes Ergebnis-Objekt für den Mode-Wechsel
+                ParsedResult res;
+                res.originalLine = line;
+                res.kind = EventKind::ModeChange;
+                res.mode = newMode;          // neue Betriebsart
+                return res;
+            }
+        }
+    }
+
+    // D-Star Slow Data Text / "link status set to" (Reflektor-/Link-Infos)
+    if (first == 'D') {
+        std::optional<std::string_view> txt;
+        LineScanner sc{body};
+        if (sc.phrase("D-Star, network slow data text")) {
+            sc.optWs();
+            if (sc.lit("=")) { sc.optWs(); txt = quoted(sc); }
+        } else if (sc.phrase("D-Star link status set to")) {
+            sc.optWs();
+            txt = quoted(sc);
+        }
+        if (txt) {
+            std::string_view t = trimView(*txt);
+            if (starts_with(t, "Verlinkt zu ")) {       // nur Link-Status
+                ParsedResult res;
+                res.originalLine = line;
+                res.kind = EventKind::Link;
+                res.mode = Mode::DStar;
+                res.source = Source::NET;
+                res.info = t.substr(12); // aus "Verlinkt zu DCS001 R"
+                return res;
+            }
+            // sonst ignorieren (kein Link-Status)
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Übertragungen; body beginnt beim Schlüsselwort
+std::optional<ParsedResult> LogParser::parseTransmission(std::string_view line, const std::optional<TimePoint>& ts,
+                                                        std::string_view body) {
+    const char first = body.empty() ? '\0' : body.front();
+    switch (first) {
+        case 'D':
+            if (body.size() > 1 && body[1] == '-') return parseDStar(line, ts, body);
+            return parseDMR(line, ts, body);
+        case 'Y':
+            return parseYSF(line, ts, body);
+        default:
+            return std::nullopt;
+    }
+}
+
+// Schlüsselwort nicht am Anfang der Meldung ("Info: DMR Slot 2, ..."): die früheren Regexe
+// fanden es an beliebiger Stelle. Nur wenn die Verteilung nach dem ersten Zeichen nichts
+// ergab; Reihenfolge der Schlüsselwörter wie die der alten Regex-Kaskade.
+std::optional<ParsedResult> LogParser::parseElsewhere(std::string_view line, const std::optional<TimePoint>& ts,
+                                                     std::string_view body) {
+    static constexpr std::string_view kHead[] = {"Mode", "D-Star"};
+    static constexpr std::string_view kTransmission[] = {"D-Star", "YSF", "DMR"};
+    if (body.size() < 2) return std::nullopt;
+    for (std::string_view kw : kHead) {
+        for (size_t at = body.find(kw, 1); at != std::string_view::npos; at = body.find(kw, at + 1))
+            if (auto res = parseHead(line, ts, body.substr(at))) return res;
+    }
+    for (std::string_view kw : kTransmission) {
+        for (size_t at = body.find(kw, 1); at != std::string_view::npos; at = body.find(kw, at + 1))
+            if (auto res = parseTransmission(line, ts, body.substr(at))) return res;
+    }
+    return std::nullopt;
+}
+
+LogParser::Session* LogParser::findSession(Mode mode, const std::optional<int>& slot) {
+    const uint8_t k = slotKey(slot);
+    for (size_t i = 0; i < sessionCount_; ++i) {
+        Session& s = sessions_[i];
+        if (s.stream == stream_ && s.st.mode == mode && s.slot == k) return &s;
+    }
+    return nullptr;
+}
+
+// --- D-Star ---
+std::optional<ParsedResult> LogParser::parseDStar(std::string_view line, const std::optional<TimePoint>& ts,
+                                                 std::string_view body) {
+    LineScanner sc{body};
+    if (!sc.phrase("D-Star, received")) return std::nullopt;
+    if (!sc.ws()) return std::nullopt;
+
+    bool net = sc.lit("network");
+    if (!net && !sc.lit("RF")) return std::nullopt;
+    const Source source = net ? Source::NET : Source::RF;
+    if (!sc.ws()) return std::nullopt;
+
+    bool isEnd = sc.phrase("end of transmission");
+    if (!isEnd) {
+        if (!(sc.lit("header") || (!net && sc.phrase("late entry")))) return std::nullopt;
+    }
+    if (!sc.ws() || !sc.lit("from") || !sc.ws()) return std::nullopt;
+    std::string_view cs = sc.token();
+    if (cs.empty()) return std::nullopt;
+
+    if (!isEnd)
+        return handleStart(line, ts, Mode::DStar, source, cs, std::nullopt);
+
+    // NET: ", <s> seconds,.*?BER: x%"   RF: ", <s> seconds, BER: x%"
+    std::string_view dur, ber;
+    bool ok = sc.seekEach(",", [&] {
+        --sc.pos;
+        if (!secondsField(sc, dur) || !sc.lit(",")) return false;
+        if (net) return seekBer(sc, ber);
+        sc.optWs();
+        return berField(sc, ber);
+    });
+    if (!ok) return std::nullopt;
+    return handleEnd(line, ts, Mode::DStar, source, cs, std::nullopt,
+                     toDouble(dur), toDouble(ber));
+}
+
+// --- YSF ---
+std::optional<ParsedResult> LogParser::parseYSF(std::string_view line, const std::optional<TimePoint>& ts,
+                                               std::string_view body) {
+    LineScanner sc{body};
+    if (!sc.lit("YSF,") || !sc.ws()) return std::nullopt;
+
+    // Watchdog-Ende ohne Callsign/DG-ID: "network watchdog has expired, <s> seconds(,...)?, BER: x%"
+    if (sc.phrase("network watchdog has expired")) {
+        std::string_view dur, ber;
+        if (!secondsField(sc, dur) || !sc.lit(",")) return std::nullopt;
+        size_t afterComma = sc.pos;
+        sc.optWs();
+        if (!berField(sc, ber)) {
+            sc.pos = afterComma;
+            size_t c = body.find(',', sc.pos);
+            if (c == std::string_view::npos) return std::nullopt;
+            sc.pos = c + 1;
+            sc.optWs();
+            if (!berField(sc, ber)) return std::nullopt;
+        }
+        return handleEnd(line, ts, Mode::YSF, Source::NET, "", std::nullopt, toDouble(dur), toDouble(ber));
+    }
+
+    if (!sc.lit("received") || !sc.ws()) return std::nullopt;
+    bool net = sc.lit("network");
+    if (!net && !sc.lit("RF")) return std::nullopt;
+    const Source source = net ? Source::NET : Source::RF;
+    if (!sc.ws()) return std::nullopt;
+
+    bool isEnd = sc.phrase("end of transmission");
+    if (!isEnd && !sc.lit(net ? "data" : "header")) return std::nullopt;
+    if (!sc.ws() || !sc.lit("from") || !sc.ws()) return std::nullopt;
+    std::string_view cs = sc.token();
+    if (cs.empty() || !sc.ws() || !sc.phrase("to DG-ID") || !sc.ws()) return std::nullopt;
+    std::string_view dg = sc.digits();
+    if (dg.empty()) return std::nullopt;
+
+    if (!isEnd)
+        return handleStart(line, ts, Mode::YSF, source, cs, toInt(dg));
+
+    // ", <s> seconds" optional gefolgt von ",.*?BER: x%"
+    std::string_view dur, ber;
+    if (!secondsField(sc, dur)) return std::nullopt;
+    std::optional<double> berPct;
+    if (sc.lit(",") && seekBer(sc, ber)) berPct = toDouble(ber);
+    return handleEnd(line, ts, Mode::YSF, source, cs, toInt(dg), toDouble(dur), berPct);
+}
+
+// --- DMR ---
+std::optional<ParsedResult> LogParser::parseDMR(std::string_view line, const std::optional<TimePoint>& ts,
+                                               std::string_view body) {
+    LineScanner sc{body};
+    if (!sc.phrase("DMR Slot") || !sc.ws()) return std::nullopt;
+    std::string_view slotStr = sc.digits();
+    if (slotStr.empty() || !sc.lit(",") || !sc.ws() || !sc.lit("received") || !sc.ws()) return std::nullopt;
+
+    bool net = sc.lit("network");
+    if (!net && !sc.lit("RF")) return std::nullopt;
+    const Source source = net ? Source::NET : Source::RF;
+    if (!sc.ws()) return std::nullopt;
+
+    bool isEnd = sc.phrase("end of voice transmission");
+    if (!isEnd && !sc.phrase("voice header")) return std::nullopt;
+    if (!sc.ws() || !sc.lit("from") || !sc.ws()) return std::nullopt;
+    std::string_view cs = sc.token();
+    if (cs.empty() || !sc.ws() || !sc.phrase("to TG") || !sc.ws()) return std::nullopt;
+    std::string_view tgStr = sc.digits();
+    if (tgStr.empty()) return std::nullopt;
+
+    int slot = toInt(slotStr);
+    int tg = toInt(tgStr);
+    if (!isEnd)
+        return handleStart(line, ts, Mode::DMR, source, cs, tg, slot);
+
+    // NET: ", <s> seconds,.*?BER: x%"   RF: ", <s> seconds, BER: x%"
+    std::string_view dur, ber;
+    if (!secondsField(sc, dur) || !sc.lit(",")) return std::nullopt;
+    if (net) {
+        if (!seekBer(sc, ber)) return std::nullopt;
+    } else {
+        sc.optWs();
+        if (!berField(sc, ber)) return std::nullopt;
+    }
+    return handleEnd(line, ts, Mode::DMR, source, cs, tg, toDouble(dur), toDouble(ber), slot);
+}
+
+// Liest den Präfix "X: YYYY-MM-DD HH:MM:SS.mmm" ohne Heap-Allokation.
+// Die Logs der G4KLX-Programme sind in UTC; die Epoche des Datums wird nur bei
+// Datumswechsel neu berechnet.
+std::optional<LogParser::TimePoint> LogParser::extractTimestamp(std::string_view line) {
+    size_t i = 0;
+    while (i < line.size() && LineScanner::isWs(line[i])) ++i;
+    if (i + 2 > line.size() || line[i] < 'A' || line[i] > 'Z' || line[i + 1] != ':') return std::nullopt;
+    i += 2;
+    size_t w = i;
+    while (i < line.size() && LineScanner::isWs(line[i])) ++i;
+    if (i == w || i + 10 > line.size()) return std::nullopt;
+
+    const char* date = line.data() + i;
+    if (date[4] != '-' || date[7] != '-') return std::nullopt;
+    i += 10;
+    w = i;
+    while (i < line.size() && LineScanner::isWs(line[i])) ++i;
+    if (i == w || i + 12 > line.size()) return std::nullopt;
+
+    const char* t = line.data() + i;
+    if (t[2] != ':' || t[5] != ':' || t[8] != '.') return std::nullopt;
+    const int hh = fixedDigits(t, 2), mi = fixedDigits(t + 3, 2), ss = fixedDigits(t + 6, 2);
+    const int ms = fixedDigits(t + 9, 3);
+    if (hh < 0 || hh > 23 || mi < 0 || mi > 59 || ss < 0 || ss > 60 || ms < 0) return std::nullopt;
+
+    if (!tsCacheValid_ || std::memcmp(tsCacheDate_, date, sizeof(tsCacheDate_)) != 0) {
+        const int y = fixedDigits(date, 4), mo = fixedDigits(date + 5, 2), d = fixedDigits(date + 8, 2);
+        if (y < 0 || mo < 1 || mo > 12 || d < 1 || d > 31) return std::nullopt;
+        std::memcpy(tsCacheDate_, date, sizeof(tsCacheDate_));
+        tsCacheDayEpoch_ = daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * 86400;
+        tsCacheValid_ = true;
+    }
+
+    const int64_t sec = tsCacheDayEpoch_ + hh * 3600 + mi * 60 + ss;
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(sec) + std::chrono::milliseconds(ms)));
+}
+
+void LogParser::endStreamSessions(std::string_view line, const std::optional<TimePoint>& ts, Mode keep) {
+    for (size_t i = 0; i < sessionCount_; ) {
+        const Session& s = sessions_[i];
+        if (s.stream != stream_ || (keep != Mode::Unknown && s.st.mode == keep)) { ++i; continue; }
+        pending_.push_back(forcedEnd(sessions_[i].st, line, ts));
+        closeSession(&sessions_[i]);
+    }
+}
+
+bool LogParser::isSelf(CallsignId id) {
+    if (localCallsign.empty() || id == 0) return false;
+    if (id >= selfMemo_.size()) selfMemo_.resize(id + 1, 0);
+    uint8_t& m = selfMemo_[id];
+    if (m == 0) {
+        std::string_view cs = callsigns().str(id);
+        m = (cs.substr(0, localCallsign.size()) == localCallsign) ? 1 : 2; // beginnt mit eigenem Callsign
+    }
+    return m == 1;
+}
+
+std::optional<ParsedResult>
+LogParser::handleStart(std::string_view line, const std::optional<TimePoint>& ts, Mode mode, Source source,
+                       std::string_view callsign, std::optional<int> dgId, std::optional<int> slotId) {
+    std::string_view csText = sanitizeCallsign(callsign);
+    if (!csText.empty() && !isValidCallsign(csText)) return std::nullopt;
+    const CallsignId cs = callsigns().intern(csText);
+
+    // Nur Netzwerk-Echos unterdrücken – RF mit eigenem Call behalten
+    if (source == Source::NET && ignoreSelfOnNET && isSelf(cs)) return std::nullopt;
+
+    // MMDVMHost arbeitet immer nur in einer Betriebsart: offene Übertragungen anderer
+    // Betriebsarten derselben Logdatei sind damit vorbei. Die Zeitschlitze bleiben unabhängig.
+    endStreamSessions(line, ts, mode);
+
+    // Falls auf derselben Session (Datei, Betriebsart, Slot) noch offen → zuerst erzwungen beenden
+    std::optional<ParsedResult> priorEnd;
+    Session* s = findSession(mode, slotId);
+    if (s) {
+        priorEnd = forcedEnd(s->st, line, ts);
+    } else {
+        // voll: die am längsten offene Session weicht (ohne Ende, da vermutlich verwaist)
+        if (sessionCount_ == kMaxSessions) {
+            closeSession(std::min_element(sessions_, sessions_ + sessionCount_,
+                [](const Session& a, const Session& b) { return a.st.startTp < b.st.startTp; }));
+        }
+        s = &sessions_[sessionCount_++];
+    }
+
+    auto stp = ts.value_or(std::chrono::system_clock::now());
+    *s = Session{stream_, slotKey(slotId), TransmissionState{mode, source, cs, dgId, slotId, stp}};
+
+    ParsedResult res;
+    res.originalLine = line;
+    res.kind = EventKind::Start;
+    res.mode = mode;
+    res.source = source;
+    res.callsign = cs;
+    res.dgId = dgId;
+    res.slot = slotId;
+    res.durationSec = std::nullopt;
+    res.berPct = std::nullopt;
+
+    if (priorEnd) pending_.push_back(std::move(*priorEnd));
+    return res;
+}
+
+std::optional<ParsedResult>
+LogParser::handleEnd(std::string_view line, const std::optional<TimePoint>& /*ts*/, Mode mode, Source source,
+                     std::string_view callsign, std::optional<int> dgId, std::optional<double> durationSec,
+                     std::optional<double> berPct, std::optional<int> slotId) {
+    std::string_view csText = sanitizeCallsign(callsign);
+    if (!csText.empty() && !isValidCallsign(csText)) return std::nullopt;
+    const CallsignId cs = callsigns().intern(csText);
+
+    if (source == Source::NET && ignoreSelfOnNET && isSelf(cs)) return std::nullopt;
+
+    // Falls das Ende kein Rufzeichen/DG-ID liefert (z. B. YSF Watchdog),
+    // nimm die Werte aus der offenen Übertragung, wenn vorhanden.
+    CallsignId outCallsign = cs;
+    std::optional<int> outDgId = dgId;
+    std::optional<int> outSlot = slotId;
+
+    if (Session* s = findSession(mode, slotId)) {
+        const TransmissionState& open = s->st;
+        if (outCallsign == 0) outCallsign = open.callsign;
+        if (!outDgId.has_value()) outDgId = open.dgId;
+        if (!outSlot.has_value()) outSlot = open.slot;
+
+        // Session dieses Slots schließen; andere Slots/Dateien bleiben offen
+        closeSession(s);
+    }
+    // Reste anderer Betriebsarten dieser Datei sind verwaist (Ende nicht geloggt) → verwerfen
+    for (size_t i = 0; i < sessionCount_; ) {
+        if (sessions_[i].stream == stream_ && sessions_[i].st.mode != mode) closeSession(&sessions_[i]);
+        else ++i;
+    }
+
+    ParsedResult res;
+    res.originalLine = line;
+    res.kind = EventKind::End;
+    res.mode = mode;
+    res.source = source;
+    res.callsign = outCallsign;
+    res.dgId = outDgId;
+    res.slot = outSlot;
+    res.durationSec = durationSec;
+    res.berPct = berPct;
+    return res;
+}
+
+// ---- Database ----
+
+Database::Database(std::string socket)
+    : db_(dbSettings(std::move(socket))) {
+    db_.onConnect([this](MYSQL* c) { return connect(c); });
+    db_.onClose([this] { destroy_statements(); conn = nullptr; });
+}
+
+bool Database::upsertStatus(Mode mode, CallsignId callsign, const std::optional<int>& dgid,
+                            const std::optional<int>& slot, Source source, bool active,
+                            const std::optional<double>& ber, const std::optional<double>& duration,
+                            std::chrono::system_clock::time_point when) {
+    // mode, callsign, dgid, slot, source, active, ber, duration, updated_at (Zeit der Logzeile)
+    return st_upsert_status.execute(modeName(mode), callsigns().str(callsign), dgid, slot,
+                                    sourceOrNull(source), active, ber, duration, unixSeconds(when));
+}
+
+bool Database::insertLastHeard(const ParsedResult* rows, size_t n, uint64_t* inserted) {
+    while (n > 0) {
+        const size_t k = std::min(n, kLastHeardRows);
+        LastHeardStmt* st = lastHeardStmt(k);
+        if (!st) return false;
+        for (size_t i = 0; i < k; ++i) setLastHeardRow(*st, i, rows[i]);
+        if (!st->execute()) return false;
+        if (inserted) *inserted += st->affectedRows();
+        rows += k;
+        n -= k;
+    }
+    return true;
+}
+
+bool Database::applyBatch(const ParsedResult* ev, size_t n) {
+    if (n == 0) return true;
+
+    lastHeardRows_.clear();
+    const ParsedResult* status = nullptr;     // letztes Start/Ende/Idle
+    const ParsedResult *dstar = nullptr, *fusion = nullptr, *dmr = nullptr; // letzte Link/Unlink je Spalte
+
+    for (size_t i = 0; i < n; ++i) {
+        const ParsedResult& r = ev[i];
+        switch (r.kind) {
+            case EventKind::Start:
+                status = &r;
+                break;
+            case EventKind::End:
+                // lastheard + status inactive
+                lastHeardRows_.push_back(r);
+                status = &r;
+                break;
+            case EventKind::ModeChange:
+                // Nur Idle: Status auf inactive setzen und Felder leeren.
+                // Nicht-Idle Mode-Events (z. B. "Mode set to D-Star") NICHT in die DB schreiben,
+                // damit ein kurz zuvor gesetzter Start-Status (active=1, Callsign=...) nicht überschrieben wird.
+                if (r.mode == Mode::Idle) status = &r;
+                break;
+            case EventKind::Link:
+                // Reflektor-/Servername ohne Präfix ("Verlinkt zu", "Linked to", "Logged into master:")
+                if (r.mode == Mode::YSF)        fusion = &r;
+                else if (r.mode == Mode::DStar) dstar = &r;
+                else if (r.mode == Mode::DMR)   dmr = &r;
+                break;
+            case EventKind::Unlink:
+                // leerer String = „nicht verbunden“
+                if (r.mode == Mode::YSF) fusion = &r; // info ist leer
+                break;
+        }
+    }
+
+    // Der ganze Stapel ist eine Operation: war die Verbindung schon weg, wiederholt DbConn sie
+    // einmal auf der neuen Verbindung; bricht sie mittendrin ab (offen, ob der COMMIT noch
+    // durchkam), meldet run() Down und der Stapel geht in den Spool. Doppelt wird dabei
+    // nichts: lastheard schreibt mit INSERT IGNORE, status und reflector sind Upserts.
+    const DbConn::Result res = db_.run([&](MYSQL* c) {
+        if (mysql_query(c, "START TRANSACTION") != 0) {
+            dlog("[DB  ] start transaction failed: ", mysql_error(c));
+            return false;
+        }
+        bool ok = insertLastHeard(lastHeardRows_.data(), lastHeardRows_.size());
+        if (ok && status) {
+            const ParsedResult& r = *status;
+            if (r.kind == EventKind::ModeChange) {
+                ok = upsertStatus(r.mode, 0, std::nullopt, std::nullopt,
+                                  Source::None, false, std::nullopt, std::nullopt, r.ts);
+            } else {
+                const bool active = r.kind == EventKind::Start;
+                ok = upsertStatus(r.mode, r.callsign, r.dgId, r.slot, r.source, active,
+                                  active ? std::nullopt : r.berPct, active ? std::nullopt : r.durationSec, r.ts);
+            }
+        }
+        if (ok && dstar)  ok = setReflectorDStar(dstar->info, dstar->ts);
+        if (ok && fusion) ok = setReflectorFusion(fusion->info, fusion->ts);
+        if (ok && dmr)    ok = setReflectorDMR(dmr->info, dmr->ts);
+
+        if (!ok) {
+            // errno der Verbindung für DbConn erhalten: rollback würde ihn überschreiben
+            if (DbConn::isConnectionLost(mysql_errno(c))) return false;
+            mysql_rollback(c);
+            return false;
+        }
+        if (mysql_commit(c) != 0) {
+            dlog("[DB  ] commit failed: ", mysql_error(c));
+            return false;
+        }
+        return true;
+    });
+    if (res == DbConn::Result::Down) return false;
+    if (res == DbConn::Result::Error) {
+        rolledBack_.fetch_add(n, std::memory_order_relaxed);
+        dlog("[DB  ] batch of ", n, " events rolled back");
+    }
+    return true;
+}
+
+long Database::importLastHeard(const std::vector<ParsedResult>& rows, size_t& skipped) {
+    long inserted = -1;
+    const DbConn::Result res = db_.run([&](MYSQL* c) {
+        skipped = 0;
+        inserted = 0;
+        if (rows.empty()) return true;
+
+        if (!st_import_lastheard.ok() && !prepareLastHeard(st_import_lastheard, kImportRows)) return false;
+        if (mysql_query(c, "START TRANSACTION") != 0) {
+            dlog("[DB  ] import: start transaction failed: ", mysql_error(c));
+            return false;
+        }
+
+        const ParsedResult* p = rows.data();
+        size_t n = rows.size();
+        uint64_t added = 0;
+        bool ok = true;
+        for (; ok && n >= kImportRows; p += kImportRows, n -= kImportRows) {
+            for (size_t i = 0; i < kImportRows; ++i) setLastHeardRow(st_import_lastheard, i, p[i]);
+            ok = st_import_lastheard.execute();
+            if (ok) added += st_import_lastheard.affectedRows();
+        }
+        if (ok) ok = insertLastHeard(p, n, &added); // Rest in Stücken zu höchstens kLastHeardRows
+
+        if (!ok) {
+            if (DbConn::isConnectionLost(mysql_errno(c))) return false;
+            mysql_rollback(c);
+            dlog("[DB  ] import of ", rows.size(), " rows rolled back");
+            return false;
+        }
+        if (mysql_commit(c) != 0) {
+            dlog("[DB  ] import: commit failed: ", mysql_error(c));
+            return false;
+        }
+        inserted = static_cast<long>(added);
+        skipped = rows.size() - added;
+        return true;
+    });
+    return res == DbConn::Result::Ok ? inserted : -1;
+}
+
+DbConn::Settings Database::dbSettings(std::string socket) {
+    DbConn::Settings s;
+    s.unixSocket = std::move(socket);
+    s.log = [](const std::string& m) { dlog("[DB  ] ", m); };
+    return s;
+}
+
+Database::LastHeardStmt* Database::lastHeardStmt(size_t rows) {
+    auto& st = st_insert_lastheard_rows[rows - 1];
+    if (!st) st = std::make_unique<LastHeardStmt>();
+    if (st->ok()) return st.get();
+    return prepareLastHeard(*st, rows) ? st.get() : nullptr;
+}
+
+bool Database::prepareLastHeard(LastHeardStmt& st, size_t rows) {
+    std::string q = "INSERT IGNORE INTO lastheard (callsign, mode, dgid, slot, source, duration, ber, ts) VALUES ";
+    for (size_t i = 0; i < rows; ++i) q += i ? ",(?, ?, ?, ?, ?, ?, ?, FROM_UNIXTIME(?))" : "(?, ?, ?, ?, ?, ?, ?, FROM_UNIXTIME(?))";
+    return st.prepare(conn, q, "insert lastheard", rows);
+}
+
+void Database::setLastHeardRow(LastHeardStmt& st, size_t i, const ParsedResult& r) {
+    st.set(i, callsigns().str(r.callsign), modeName(r.mode), r.dgId, r.slot,
+           sourceOrNull(r.source), r.durationSec, r.berPct, unixSecondsMs(r.ts));
+}
+
+std::optional<std::string_view> Database::sourceOrNull(Source s) {
+    if (s == Source::None) return std::nullopt;
+    return sourceName(s);
+}
+
+bool Database::connect(MYSQL* c) {
+    conn = c;
+    dlog("[DB  ] connected via unix_socket=", db_.unixSocket(), " db=mmdvmdb");
+    const char* q1 =
+        "CREATE TABLE IF NOT EXISTS lastheard ("
+        " id INT AUTO_INCREMENT PRIMARY KEY,"
+        " callsign VARCHAR(20),"
+        " mode VARCHAR(20),"
+        " dgid INT NULL,"
+        " slot TINYINT NULL,"
+        " source ENUM('RF','NET') NULL,"
+        " duration FLOAT,"
+        " ber FLOAT,"
+        " ts DATETIME(3) DEFAULT CURRENT_TIMESTAMP(3),"
+        " slot_key TINYINT AS (IFNULL(slot, -1)) STORED,"
+        " UNIQUE KEY uniq_event (ts, callsign, mode, slot_key)"
+        ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;";
+    if (mysql_query(conn, q1) != 0) dlog("[DB  ] create lastheard failed: ", mysql_error(conn));
+    ensureEventKey();
+
+    const char* q2 =
+        "CREATE TABLE IF NOT EXISTS status ("
+        " id TINYINT PRIMARY KEY,"
+        " mode VARCHAR(20),"
+        " callsign VARCHAR(20),"
+        " dgid INT NULL,"
+        " slot TINYINT NULL,"
+        " source ENUM('RF','NET') NULL,"
+        " active BOOL,"
+        " ber FLOAT,"
+        " duration FLOAT,"
+        " updated_at DATETIME"
+        ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;";
+    if (mysql_query(conn, q2) != 0) dlog("[DB  ] create status failed: ", mysql_error(conn));
+
+    const char* q3 =
+        "CREATE TABLE IF NOT EXISTS reflector ("
+        " id TINYINT PRIMARY KEY,"
+        " dstar  VARCHAR(64) NULL,"
+        " dmr    VARCHAR(64) NULL,"
+        " fusion VARCHAR(64) NULL,"
+        " updated_at DATETIME"
+        ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;";
+    if (mysql_query(conn, q3) != 0) dlog("[DB  ] create reflector failed: ", mysql_error(conn));
+
+    mysql_query(conn, "INSERT IGNORE INTO reflector (id,dstar,dmr,fusion,updated_at) "
+                      "VALUES (1,NULL,NULL,NULL,NOW());");
+
+    prepare_statements();
+    mysql_query(conn, "INSERT IGNORE INTO status (id,mode,callsign,dgid,slot,source,active,ber,duration,updated_at) "
+               "VALUES (1,'Idle','',NULL,NULL,'RF',0,NULL,NULL,NOW());");
+    return true;
+}
+
+// Erste Spalte der ersten Zeile als Zahl (NULL → 0); false bei Fehler
+static bool queryNumber(MYSQL* c, const char* sql, long long& out) {
+    if (mysql_query(c, sql) != 0) return false;
+    MYSQL_RES* res = mysql_store_result(c);
+    if (!res) return false;
+    out = 0;
+    if (MYSQL_ROW row = mysql_fetch_row(res); row && row[0]) out = std::atoll(row[0]);
+    mysql_free_result(res);
+    return true;
+}
+
+// Ein Ereignis steht nur einmal in lastheard: INSERT IGNORE überspringt dieselbe Logzeile bei
+// einem wiederholten --import oder wenn der Dienst nach einem Neustart ab der gespeicherten
+// Position erneut liest. Die Identität ist der Zeitstempel der Logzeile auf die Millisekunde
+// (ts DATETIME(3)) mit Rufzeichen, Betriebsart und Slot; zwei echte Durchgänge in derselben
+// Sekunde bleiben so getrennt. slot ist außerhalb von DMR NULL, und NULL ist in einem UNIQUE KEY
+// nie gleich – deshalb die berechnete Spalte slot_key.
+// Ältere Tabellen werden hier umgestellt. Zeilen, die den Schlüssel verletzen (aus der Zeit mit
+// Sekunden-Zeitstempeln), wandern vorher nach lastheard_duplicates statt stillschweigend zu verschwinden.
+void Database::ensureEventKey() {
+    long long precision = 0, keys = 0;
+    if (!queryNumber(conn, "SELECT DATETIME_PRECISION FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = DATABASE()"
+                           " AND TABLE_NAME = 'lastheard' AND COLUMN_NAME = 'ts'", precision) ||
+        !queryNumber(conn, "SELECT COUNT(*) FROM information_schema.STATISTICS WHERE TABLE_SCHEMA = DATABASE()"
+                           " AND TABLE_NAME = 'lastheard' AND INDEX_NAME = 'uniq_event'", keys)) {
+        dlog("[DB  ] lastheard: schema lookup failed: ", mysql_error(conn));
+        return;
+    }
+
+    if (precision < 3) {
+        dlog("[DB  ] lastheard: widening ts to DATETIME(3)");
+        if (mysql_query(conn, "ALTER TABLE lastheard MODIFY ts DATETIME(3) DEFAULT CURRENT_TIMESTAMP(3)") != 0) {
+            dlog("[DB  ] lastheard: widening ts failed: ", mysql_error(conn));
+            return;
+        }
+    }
+    if (keys > 0) return;
+
+    if (mysql_query(conn, "ALTER TABLE lastheard ADD COLUMN IF NOT EXISTS slot_key TINYINT AS (IFNULL(slot, -1)) STORED") != 0) {
+        dlog("[DB  ] lastheard: adding slot_key failed: ", mysql_error(conn));
+        return;
+    }
+
+    // Von jeder Gruppe gleicher Ereignisse bleibt die erste Zeile, die übrigen werden gesichert
+    static const char* kDuplicates =
+        " FROM lastheard l JOIN (SELECT ts, callsign, mode, slot_key, MIN(id) AS keep_id FROM lastheard"
+        "  GROUP BY ts, callsign, mode, slot_key HAVING COUNT(*) > 1) g"
+        " ON g.ts = l.ts AND g.callsign = l.callsign AND g.mode = l.mode AND g.slot_key = l.slot_key"
+        " AND l.id <> g.keep_id";
+    long long dupes = 0;
+    if (!queryNumber(conn, (std::string("SELECT COUNT(*)") + kDuplicates).c_str(), dupes)) {
+        dlog("[DB  ] lastheard: duplicate lookup failed: ", mysql_error(conn));
+        return;
+    }
+    if (dupes > 0) {
+        const std::string save =
+            std::string("INSERT IGNORE INTO lastheard_duplicates (id, callsign, mode, dgid, slot, source, duration, ber, ts)"
+                        " SELECT l.id, l.callsign, l.mode, l.dgid, l.slot, l.source, l.duration, l.ber, l.ts") + kDuplicates;
+        if (mysql_query(conn, "CREATE TABLE IF NOT EXISTS lastheard_duplicates ("
+                              " id INT PRIMARY KEY, callsign VARCHAR(20), mode VARCHAR(20), dgid INT NULL,"
+                              " slot TINYINT NULL, source ENUM('RF','NET') NULL, duration FLOAT, ber FLOAT,"
+                              " ts DATETIME(3)) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4") != 0 ||
+            mysql_query(conn, save.c_str()) != 0 ||
+            mysql_query(conn, "DELETE l FROM lastheard l JOIN lastheard_duplicates d ON d.id = l.id") != 0) {
+            dlog("[DB  ] lastheard: saving duplicate rows failed: ", mysql_error(conn));
+            return;
+        }
+        dlog("[DB  ] lastheard: moved ", dupes, " duplicate rows to lastheard_duplicates");
+    }
+
+    dlog("[DB  ] lastheard: adding unique key uniq_event");
+    if (mysql_query(conn, "ALTER TABLE lastheard ADD UNIQUE KEY uniq_event (ts, callsign, mode, slot_key)") != 0)
+        dlog("[DB  ] lastheard: adding uniq_event failed: ", mysql_error(conn));
+}
+
+void Database::prepare_statements() {
+    destroy_statements();
+
+    st_upsert_status.prepare(conn,
+        "INSERT INTO status (id, mode, callsign, dgid, slot, source, active, ber, duration, updated_at) "
+        "VALUES (1, ?, ?, ?, ?, ?, ?, ?, ?, FROM_UNIXTIME(?)) "
+        "ON DUPLICATE KEY UPDATE "
+        " mode=VALUES(mode), callsign=VALUES(callsign), dgid=VALUES(dgid), slot=VALUES(slot), source=VALUES(source), "
+        " active=VALUES(active), ber=VALUES(ber), duration=VALUES(duration), updated_at=VALUES(updated_at);",
+        "upsert status");
+
+    st_upsert_reflector_dstar.prepare(conn,
+        "INSERT INTO reflector (id, dstar, updated_at) "
+        "VALUES (1, ?, FROM_UNIXTIME(?)) "
+        "ON DUPLICATE KEY UPDATE "
+        " dstar=VALUES(dstar), updated_at=VALUES(updated_at);",
+        "upsert reflector.dstar");
+
+    st_upsert_reflector_fusion.prepare(conn,
+        "INSERT INTO reflector (id, fusion, updated_at) "
+        "VALUES (1, ?, FROM_UNIXTIME(?)) "
+        "ON DUPLICATE KEY UPDATE "
+        " fusion=VALUES(fusion), updated_at=VALUES(updated_at);",
+        "upsert reflector.fusion");
+
+    st_upsert_reflector_dmr.prepare(conn,
+        "INSERT INTO reflector (id, dmr, updated_at) "
+        "VALUES (1, ?, FROM_UNIXTIME(?)) "
+        "ON DUPLICATE KEY UPDATE "
+        " dmr=VALUES(dmr), updated_at=VALUES(updated_at);",
+        "upsert reflector.dmr");
+}
+
+void Database::destroy_statements() {
+    st_upsert_status.close();
+    for (auto& st : st_insert_lastheard_rows) {
+        if (st) st->close();
+    }
+    st_import_lastheard.close();
+    st_upsert_reflector_dstar.close();
+    st_upsert_reflector_fusion.close();
+    st_upsert_reflector_dmr.close();
+}
+
+// ---- EventSpool ----
+
+EventSpool::~EventSpool() {
+    if (map_) ::munmap(map_, size_);
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool EventSpool::open(const std::string& path, size_t bytes) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) { dlog("[SPL ] open ", path, " failed: ", std::strerror(errno)); return false; }
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) st.st_size = 0;
+    // Größe einer vorhandenen Datei zunächst beibehalten: sie kann noch Ereignisse enthalten
+    const size_t want = kHeaderBytes + bytes;
+    if (!map(path, st.st_size > static_cast<off_t>(kHeaderBytes) ? static_cast<size_t>(st.st_size) : want)) return false;
+
+    if (std::memcmp(hdr_->magic, kMagic, sizeof(kMagic)) != 0 || hdr_->version != kVersion ||
+        hdr_->head > hdr_->tail || hdr_->tail > cap_) {
+        reset();
+    }
+
+    // Bestand zählen; alles ab dem ersten unlesbaren Datensatz verwerfen
+    uint64_t pos = hdr_->head, n = 0;
+    ParsedResult r;
+    while (pos < hdr_->tail && decodeAt(pos, r)) ++n;
+    if (pos != hdr_->tail) {
+        dlog("[SPL ] ", path, ": discarding ", hdr_->tail - pos, " unreadable bytes");
+        hdr_->tail = pos;
+        syncHeader();
+    }
+    depth_.store(n);
+    used_.store(hdr_->tail - hdr_->head);
+
+    // --spool-mb geändert: leer gleich umstellen, sonst erst beim nächsten Start nach dem Nachtragen
+    if (size_ != want) {
+        if (n == 0) {
+            dlog("[SPL ] ", path, ": resizing from ", cap_, " to ", bytes, " bytes");
+            ::munmap(map_, size_);
+            map_ = nullptr;
+            if (::ftruncate(fd_, static_cast<off_t>(want)) != 0) {
+                dlog("[SPL ] resize ", path, " failed: ", std::strerror(errno));
+                return fail();
+            }
+            if (!map(path, want)) return false;
+            reset();
+        } else {
+            dlog("[SPL ] ", path, ": has ", cap_, " bytes but ", bytes, " are configured; keeping the size"
+                 " until the ", n, " pending events are written (applies on the next start)");
+        }
+    }
+    if (n) dlog("[SPL ] ", path, ": ", n, " events pending from previous run");
+    return true;
+}
+
+// Datei auf size bringen und einblenden; Platz fest reservieren (kein SIGBUS bei vollem Dateisystem)
+bool EventSpool::map(const std::string& path, size_t size) {
+    const int err = ::posix_fallocate(fd_, 0, static_cast<off_t>(size));
+    if (err != 0) { dlog("[SPL ] allocate ", path, " failed: ", std::strerror(err)); return fail(); }
+    void* m = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (m == MAP_FAILED) { dlog("[SPL ] mmap ", path, " failed: ", std::strerror(errno)); return fail(); }
+    map_ = static_cast<uint8_t*>(m);
+    size_ = size;
+    hdr_ = reinterpret_cast<Header*>(map_);
+    data_ = map_ + kHeaderBytes;
+    cap_ = size_ - kHeaderBytes;
+    return true;
+}
+
+// Leerer Spool mit gültigem Kopf
+void EventSpool::reset() {
+    std::memcpy(hdr_->magic, kMagic, sizeof(kMagic));
+    hdr_->version = kVersion;
+    hdr_->head = hdr_->tail = 0;
+    syncHeader();
+}
+
+size_t EventSpool::append(const ParsedResult* ev, size_t n) {
+    if (!ok() || n == 0) return 0;
+    uint64_t pos = hdr_->tail, syncFrom = pos;
+    size_t stored = 0;
+    for (; stored < n; ++stored) {
+        const size_t len = encode(ev[stored]);
+        if (pos + kFrameBytes + len > cap_) {
+            if (!compact(pos, kFrameBytes + len)) break;
+            syncFrom = pos;
+        }
+        const uint32_t len32 = static_cast<uint32_t>(len);
+        const uint32_t crc = static_cast<uint32_t>(::crc32(0, buf_, static_cast<uInt>(len)));
+        std::memcpy(data_ + pos, &len32, 4);
+        std::memcpy(data_ + pos + 4, &crc, 4);
+        std::memcpy(data_ + pos + kFrameBytes, buf_, len);
+        pos += kFrameBytes + len;
+    }
+    if (stored == 0) return 0;
+    syncRange(syncFrom, pos);
+    hdr_->tail = pos;
+    syncHeader();
+    depth_.fetch_add(stored);
+    return stored;
+}
+
+size_t EventSpool::peek(std::vector<ParsedResult>& out, size_t max) {
+    out.clear();
+    if (!ok()) return 0;
+    uint64_t pos = hdr_->head;
+    ParsedResult r;
+    while (out.size() < max && pos < hdr_->tail && decodeAt(pos, r)) out.push_back(r);
+    if (out.size() < max && pos < hdr_->tail) {
+        // nach der Prüfung in open() nicht zu erwarten – Rest verwerfen statt festzuhängen
+        dlog("[SPL ] discarding ", hdr_->tail - pos, " unreadable bytes");
+        hdr_->tail = pos;
+        syncHeader();
+        depth_.store(out.size());
+    }
+    peekEnd_ = pos;
+    return out.size();
+}
+
+void EventSpool::consume(size_t n) {
+    hdr_->head = peekEnd_;
+    if (hdr_->head >= hdr_->tail) hdr_->head = hdr_->tail = 0;
+    syncHeader();
+    depth_.fetch_sub(n);
+}
+
+bool EventSpool::fail() {
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+}
+
+// Platz schaffen: den noch offenen Teil [head, pos) an den Anfang kopieren. Nur wenn sich
+// Quelle und Ziel nicht überlappen – bis der Kopf umgestellt ist, bleibt das Original gültig.
+bool EventSpool::compact(uint64_t& pos, size_t need) {
+    const uint64_t head = hdr_->head, live = pos - head;
+    if (head < live || live + need > cap_) return false;
+    std::memcpy(data_, data_ + head, live);
+    syncRange(0, live);
+    hdr_->head = 0;
+    hdr_->tail = live;
+    syncHeader();
+    pos = live;
+    return true;
+}
+
+void EventSpool::syncRange(uint64_t from, uint64_t to) {
+    if (to <= from) return;
+    const long page = ::sysconf(_SC_PAGESIZE);
+    const uint64_t a = (kHeaderBytes + from) / page * page;
+    if (::msync(map_ + a, kHeaderBytes + to - a, MS_SYNC) != 0)
+        dlog("[SPL ] msync failed: ", std::strerror(errno));
+}
+
+void EventSpool::syncHeader() {
+    used_.store(hdr_->tail - hdr_->head, std::memory_order_relaxed);
+    if (::msync(map_, kHeaderBytes, MS_SYNC) != 0) dlog("[SPL ] msync failed: ", std::strerror(errno));
+}
+
+// Ereignis → buf_: kind, mode, source, flags, dgId, slot, duration, ber, ts[ms], Rufzeichen, info
+size_t EventSpool::encode(const ParsedResult& r) {
+    uint8_t* p = buf_;
+    auto put = [&p](const void* v, size_t n) { std::memcpy(p, v, n); p += n; };
+    const uint8_t flags = (r.dgId ? 1 : 0) | (r.slot ? 2 : 0) | (r.durationSec ? 4 : 0) | (r.berPct ? 8 : 0);
+    const uint8_t head[4] = {static_cast<uint8_t>(r.kind), static_cast<uint8_t>(r.mode),
+                             static_cast<uint8_t>(r.source), flags};
+    put(head, 4);
+    const int32_t dg = r.dgId.value_or(0), sl = r.slot.value_or(0);
+    const double dur = r.durationSec.value_or(0), ber = r.berPct.value_or(0);
+    const int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(r.ts.time_since_epoch()).count();
+    put(&dg, 4); put(&sl, 4); put(&dur, 8); put(&ber, 8); put(&ms, 8);
+    const std::string_view cs = callsigns().str(r.callsign);
+    const std::string_view info = r.info.view();
+    const uint8_t csLen = static_cast<uint8_t>(cs.size()), infoLen = static_cast<uint8_t>(info.size());
+    put(&csLen, 1); put(cs.data(), csLen);
+    put(&infoLen, 1); put(info.data(), infoLen);
+    return static_cast<size_t>(p - buf_);
+}
+
+// Datensatz bei pos prüfen und lesen; pos rückt bei Erfolg hinter den Datensatz
+bool EventSpool::decodeAt(uint64_t& pos, ParsedResult& r) const {
+    if (pos + kFrameBytes > hdr_->tail) return false;
+    uint32_t len, crc;
+    std::memcpy(&len, data_ + pos, 4);
+    std::memcpy(&crc, data_ + pos + 4, 4);
+    const uint8_t* p = data_ + pos + kFrameBytes;
+    if (len < 38 || len > kMaxRecord || pos + kFrameBytes + len > hdr_->tail) return false;
+    if (static_cast<uint32_t>(::crc32(0, p, len)) != crc) return false;
+
+    const uint8_t* end = p + len;
+    auto get = [&p](void* v, size_t n) { std::memcpy(v, p, n); p += n; };
+    uint8_t head[4];
+    int32_t dg, sl;
+    double dur, ber;
+    int64_t ms;
+    get(head, 4); get(&dg, 4); get(&sl, 4); get(&dur, 8); get(&ber, 8); get(&ms, 8);
+    uint8_t csLen = *p++;
+    if (p + csLen + 1 > end) return false;
+    const std::string_view cs(reinterpret_cast<const char*>(p), csLen);
+    p += csLen;
+    uint8_t infoLen = *p++;
+    if (p + infoLen != end) return false;
+
+    r = ParsedResult{};
+    r.kind = static_cast<EventKind>(head[0]);
+    r.mode = static_cast<Mode>(head[1]);
+    r.source = static_cast<Source>(head[2]);
+    if (head[3] & 1) r.dgId = dg;
+    if (head[3] & 2) r.slot = sl;
+    if (head[3] & 4) r.durationSec = dur;
+    if (head[3] & 8) r.berPct = ber;
+    r.ts = std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+    r.callsign = callsigns().intern(cs);
+    r.info = std::string_view(reinterpret_cast<const char*>(p), infoLen);
+    pos += kFrameBytes + len;
+    return true;
+}
+
+// ---- DbWriter ----
+
+DbWriter::DbWriter(Database& db, EventSpool* spool) : db_(db), spool_(spool) {
+    efd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (efd_ < 0) dlog("[DBQ ] eventfd failed: ", std::strerror(errno), " -> polling");
+    thread_ = std::thread([this] { run(); });
+}
+
+DbWriter::~DbWriter() {
+    stop_.store(true);
+    wake();
+    if (thread_.joinable()) thread_.join();
+    if (efd_ >= 0) ::close(efd_);
+}
+
+bool DbWriter::post(const ParsedResult& r) {
+    if (tryPost(r)) return true;
+    drops_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool DbWriter::tryPost(const ParsedResult& r) {
+    ParsedResult ev = r;
+    ev.originalLine = {}; // zeigt in den Lesepuffer
+    if (!queue_.tryPush(ev)) return false;
+    ++posted_;
+    const size_t depth = queue_.size();
+    if (depth > highWater_.load(std::memory_order_relaxed))
+        highWater_.store(depth, std::memory_order_relaxed);
+    // Normalerweise weckt erst flush() am Tick-Ende; läuft die Queue voll, schon vorher
+    if (depth >= queue_.capacity() / 2) flush();
+    return true;
+}
+
+void DbWriter::checkpoint(const std::map<std::string, OffsetEntry>& offsets) {
+    std::lock_guard<std::mutex> lk(cpMtx_);
+    cpOffsets_ = offsets;
+    cpSeq_ = posted_;
+    cpPending_.store(true);
+}
+
+// Checkpoint speichern, sobald die Ereignisse davor in der DB sind
+void DbWriter::maybeCheckpoint() {
+    if (!cpPending_.load()) return;
+    std::map<std::string, OffsetEntry> offsets;
+    {
+        std::lock_guard<std::mutex> lk(cpMtx_);
+        if (consumed_ < cpSeq_) return;
+        offsets.swap(cpOffsets_);
+        cpPending_.store(false);
+    }
+    // Zurückhalten nur, solange seit dem vorigen Checkpoint neue Verluste dazukommen
+    if (const uint64_t n = missing(); n > cpMissing_) {
+        dlog("[OFFS] ", n - cpMissing_, " events did not reach the database, keeping the saved read positions"
+             " (a restart reads from there again)");
+        cpMissing_ = n;
+        cpHeld_ = true;
+        return;
+    }
+    if (cpHeld_) {
+        dlog("[OFFS] no further losses, saving read positions again");
+        cpHeld_ = false;
+    }
+    saveOffsets(offsets);
+}
+
+// Stapel direkt in die DB, solange der Spool leer ist. Sonst – und wenn die DB nicht
+// erreichbar ist – hinten an den Spool, damit nichts an älteren Ereignissen vorbeiläuft.
+void DbWriter::store(const std::vector<ParsedResult>& batch) {
+    if (spool_ && !spool_->empty()) drainSpool();
+    if ((!spool_ || spool_->empty()) && db_.applyBatch(batch.data(), batch.size())) return;
+
+    if (!spool_ || !spool_->ok()) { lost_.fetch_add(batch.size(), std::memory_order_relaxed); return; }
+    if (spool_->empty()) {
+        dlog("[SPL ] database unavailable, spooling events");
+        retryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(kSpoolRetryMs);
+    }
+    const size_t n = spool_->append(batch.data(), batch.size());
+    spooled_ += n;
+    if (n < batch.size()) {
+        lost_.fetch_add(batch.size() - n, std::memory_order_relaxed);
+        dlog("[SPL ] spool full (", spool_->bytesUsed(), "/", spool_->capacity(), " bytes), dropped ",
+             batch.size() - n, " events");
+    }
+}
+
+// Spool in Stapeln nachtragen; schlägt das fehl, frühestens nach kSpoolRetryMs erneut
+void DbWriter::drainSpool() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < retryAt_) return;
+    const uint64_t before = drained_;
+    while (!spool_->empty()) {
+        const size_t n = spool_->peek(drain_, kMaxBatch);
+        if (n == 0) break;
+        if (!db_.applyBatch(drain_.data(), n)) {
+            retryAt_ = now + std::chrono::milliseconds(kSpoolRetryMs);
+            break;
+        }
+        spool_->consume(n);
+        drained_ += n;
+    }
+    if (drained_ != before)
+        dlog("[SPL ] drained ", drained_ - before, " events, ", spool_->depth(), " left");
+}
+
+void DbWriter::wake() {
+    if (efd_ < 0) return;
+    uint64_t one = 1;
+    ssize_t n = ::write(efd_, &one, sizeof(one));
+    (void)n; // EAGAIN nur bei übergelaufenem Zähler – dann ist ohnehin ein Wecksignal anhängig
+}
+
+void DbWriter::run() {
+    auto lastStats = std::chrono::steady_clock::now();
+    uint64_t lastDrops = 0, lastWritten = 0, lastSpool = 0;
+    std::vector<ParsedResult> batch;
+    batch.reserve(kMaxBatch);
+    ParsedResult ev;
+
+    for (;;) {
+        // alles, was seit dem letzten Durchlauf (typisch: ein Lese-Tick) anlag, in eine Transaktion
+        while (batch.size() < kMaxBatch && queue_.tryPop(ev)) batch.push_back(ev);
+        if (!batch.empty()) {
+            store(batch);
+            consumed_ += batch.size();
+            if (commitHook_) commitHook_(consumed_);
+            written_.fetch_add(batch.size(), std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+            batch.clear();
+            maybeCheckpoint();
+            continue;
+        }
+        if (spool_ && !spool_->empty()) drainSpool();
+        maybeCheckpoint();
+        if (stop_.load()) break;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastStats >= std::chrono::milliseconds(kStatsIntervalMs)) {
+            lastStats = now;
+            if (written() != lastWritten || drops() != lastDrops || spoolDepth() != lastSpool) {
+                dlog("[DBQ ] depth=", depth(), " high=", highWater(), "/", queue_.capacity(),
+                     " drops=", drops(), " written=", written(), " batches=", batches(),
+                     " spool=", spoolDepth(), " spooled=", spooled_, " drained=", drained_, " lost=", lost(),
+                     " ", db_.dbConn().countersText());
+                lastWritten = written();
+                lastDrops = drops();
+                lastSpool = spoolDepth();
+            }
+        }
+
+        // Schlafen anmelden und danach erneut prüfen, damit kein post() verloren geht
+        sleeping_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.size() > 0 || cpPending_.load() || stop_.load()) { sleeping_.store(false); continue; }
+
+        // mit gefülltem Spool regelmäßig aufwachen und neu verbinden
+        const int timeoutMs = (spool_ && !spool_->empty()) ? kSpoolRetryMs : kStatsIntervalMs;
+        if (efd_ >= 0) {
+            pollfd pfd{efd_, POLLIN, 0};
+            if (::poll(&pfd, 1, timeoutMs) > 0) {
+                uint64_t cnt;
+                ssize_t n = ::read(efd_, &cnt, sizeof(cnt));
+                (void)n;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        sleeping_.store(false);
+    }
+}
+
+// ---- EventMerger ----
+
+void EventMerger::push(StreamId stream, const ParsedResult& r) {
+    setStreamCount(stream + 1);
+    closed_[stream] = 0;
+    ParsedResult ev = r;
+    ev.originalLine = {}; // zeigt in den Lesepuffer
+    streams_[stream].push_back(Held{ev, std::chrono::steady_clock::now()});
+    ++held_;
+}
+
+int EventMerger::msUntilDue() const {
+    if (held_ == 0) return -1;
+    auto due = std::chrono::steady_clock::time_point::max();
+    for (const auto& q : streams_) {
+        if (!q.empty()) due = std::min(due, q.front().arrived + window_);
+    }
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(due - std::chrono::steady_clock::now()).count();
+    return ms < 0 ? 0 : static_cast<int>(ms);
+}
+
+// ---- LogWatcher ----
+
+LogWatcher::LogWatcher() {
+    ifd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (ifd_ < 0) { dlog("[WATCH] inotify_init1 failed: ", std::strerror(errno), " -> polling"); return; }
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd_ < 0) { dlog("[WATCH] epoll_create1 failed: ", std::strerror(errno), " -> polling"); return; }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = ifd_;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, ifd_, &ev) != 0) {
+        dlog("[WATCH] epoll_ctl failed: ", std::strerror(errno), " -> polling");
+        ::close(epfd_); epfd_ = -1;
+    }
+}
+
+LogWatcher::~LogWatcher() {
+    if (epfd_ >= 0) ::close(epfd_);
+    if (ifd_ >= 0) ::close(ifd_);
+}
+
+bool LogWatcher::watch(const std::vector<std::string>& paths) {
+    if (!ok()) return false;
+    bool all = true;
+    for (const auto& p : paths) {
+        std::filesystem::path fp(p);
+        names_.insert(fp.filename().string());
+        std::string dir = fp.parent_path().empty() ? std::string(".") : fp.parent_path().string();
+        if (dirs_.count(dir)) continue;
+        int wd = inotify_add_watch(ifd_, dir.c_str(),
+                                   IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE |
+                                   IN_DELETE_SELF | IN_MOVE_SELF);
+        if (wd < 0) { all = false; continue; }
+        dirs_[dir] = wd;
+        wdDirs_[wd] = dir;
+    }
+    return all;
+}
+
+bool LogWatcher::wait(int timeoutMs) {
+    if (!ok()) {
+        if (timeoutMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+    epoll_event ev{};
+    int n = epoll_wait(epfd_, &ev, 1, timeoutMs);
+    if (n <= 0) return false;
+    return drain();
+}
+
+bool LogWatcher::drain() {
+    alignas(inotify_event) char buf[4096];
+    bool relevant = false;
+    for (;;) {
+        ssize_t len = ::read(ifd_, buf, sizeof(buf));
+        if (len <= 0) break;
+        for (char* p = buf; p < buf + len; ) {
+            auto* e = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + e->len;
+            if (e->mask & IN_Q_OVERFLOW) { relevant = true; continue; }
+            if (e->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                // Verzeichnis weg → beim nächsten watch() neu anlegen
+                if (auto it = wdDirs_.find(e->wd); it != wdDirs_.end()) {
+                    dirs_.erase(it->second);
+                    wdDirs_.erase(it);
+                }
+                relevant = true;
+                continue;
+            }
+            if (e->len == 0) continue;
+            std::string_view name(e->name);
+            if (names_.count(std::string(name)) || isLogName(name)) relevant = true;
+        }
+    }
+    return relevant;
+}
+
+// ---- LogReader ----
+
+void LogReader::closeFd() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    inode_ = 0;
+    carryLen_ = 0;
+    lastSize_ = 0;
+    sigLen_ = 0;
+}
+
+void LogReader::rememberTail(uint64_t offset) {
+    sigOffset_ = offset;
+    sigLen_ = static_cast<size_t>(std::min<uint64_t>(kSigBytes, offset));
+    if (sigLen_ && ::pread(fd_, sig_, sigLen_, static_cast<off_t>(offset - sigLen_)) != static_cast<ssize_t>(sigLen_))
+        sigLen_ = 0;
+}
+
+bool LogReader::replacedBefore(uint64_t offset) {
+    if (fd_ < 0 || sigLen_ == 0 || sigOffset_ != offset) return false;
+    char now[kSigBytes];
+    const ssize_t n = ::pread(fd_, now, sigLen_, static_cast<off_t>(offset - sigLen_));
+    return n != static_cast<ssize_t>(sigLen_) || std::memcmp(now, sig_, sigLen_) != 0;
+}
+
+bool LogReader::ensureOpen() {
+    struct stat st{};
+    if (::stat(path_.c_str(), &st) != 0) { closeFd(); return false; }
+    if (fd_ >= 0 && static_cast<uint64_t>(st.st_ino) == inode_) return true;
+
+    closeFd();
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        static std::unordered_set<std::string> warned; // <unordered_set> includen
+        if (!warned.count(path_)) {
+            std::cerr << "[warn] kann Datei nicht öffnen: " << path_ << " (evtl. Rechte?)\n";
+            warned.insert(path_);
+        }
+        return false;
+    }
+    inode_ = static_cast<uint64_t>(st.st_ino);
+    return true;
+}
+
+uint64_t processFileFromOffset(LogReader& reader,
+                               LogParser& parser,
+                               EventMerger& merger,
+                               uint64_t startOffset,
+                               StreamId stream,
+                               std::vector<ParsedResult>& pending)
+{
+    return reader.readFrom(startOffset, [&](std::string_view line) {
+        auto res = parser.processLine(line, stream);
+
+        // zuerst evtl. erzwungene Enden
+        parser.takePending(pending);
+        for (const auto& p : pending) {
+            printResult(p);
+            merger.push(stream, p);
+        }
+
+        // dann das aktuelle Ergebnis
+        if (res) {
+            printResult(*res);
+            merger.push(stream, *res);
+        }
+    });
+}
+
+namespace {
+
+// Ruft onLine für jede Zeile der Datei von hinten nach vorn auf (ohne \r\n), bis onLine
+// false liefert oder der Dateianfang erreicht ist. Liest blockweise mit pread.
+template <typename F>
+static void scanLinesBackward(const std::string& path, F&& onLine) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) { ::close(fd); return; }
+
+    constexpr size_t kBlock = 64 * 1024;
+    std::vector<char> data;
+    std::vector<char> tail;               // Zeilenende, dessen Anfang im vorherigen Block liegt
+    uint64_t blockEnd = static_cast<uint64_t>(st.st_size);
+
+    while (blockEnd > 0) {
+        const uint64_t blockStart = blockEnd > kBlock ? blockEnd - kBlock : 0;
+        data.resize(static_cast<size_t>(blockEnd - blockStart));
+        size_t got = 0;
+        while (got < data.size()) {
+            ssize_t n = ::pread(fd, data.data() + got, data.size() - got, static_cast<off_t>(blockStart + got));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            got += static_cast<size_t>(n);
+        }
+        if (got < data.size()) break; // Datei während des Lesens gekürzt
+        data.insert(data.end(), tail.begin(), tail.end());
+
+        size_t end = data.size();
+        for (;;) {
+            const void* nl = end ? ::memrchr(data.data(), '\n', end) : nullptr;
+            if (!nl && blockStart > 0) break; // Zeilenanfang liegt im vorherigen Block
+            const size_t from = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data.data()) + 1 : 0;
+            std::string_view line(data.data() + from, end - from);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty() && !onLine(line)) { ::close(fd); return; }
+            if (!nl) break;
+            end = from - 1;
+        }
+        tail.assign(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(end));
+        blockEnd = blockStart;
+    }
+    ::close(fd);
+}
+
+// Welche Reflektor-Spalten eine Logdatei liefert (nach FileRoot der G4KLX-Programme)
+static std::vector<Mode> reflectorModesFor(const std::string& path) {
+    const std::string name = std::filesystem::path(path).filename().string();
+    if (starts_with(name, "MMDVM-"))      return {Mode::DStar};
+    if (starts_with(name, "YSFGateway-")) return {Mode::YSF};
+    if (starts_with(name, "DMRGateway-")) return {Mode::DMR};
+    return {Mode::DStar, Mode::YSF, Mode::DMR};
+}
+
+// Log des Vortags zu "<Root>-YYYY-MM-DD.log": erst die Datei selbst, dann die von
+// logrotate (delaycompress) erzeugte Kopie "<...>.log.1".
+static std::vector<std::string> previousDayLogs(const std::string& path) {
+    std::filesystem::path fp(path);
+    const std::string name = fp.filename().string();
+    const size_t n = name.size();
+    if (n < 15 || name.compare(n - 4, 4, ".log") != 0 || name[n - 15] != '-') return {};
+
+    std::tm tm{};
+    const std::string date = name.substr(n - 14, 10);
+    std::istringstream is(date);
+    is >> std::get_time(&tm, "%Y-%m-%d");
+    if (is.fail()) return {};
+    tm.tm_mday -= 1;
+    std::time_t tt = timegm(&tm);   // normalisiert auch Monats-/Jahreswechsel
+    gmtime_r(&tt, &tm);
+    std::ostringstream os;
+    os << std::put_time(&tm, "%Y-%m-%d");
+
+    const std::string prev = (fp.parent_path() / (name.substr(0, n - 14) + os.str() + ".log")).string();
+    return {prev, prev + ".1"};
+}
+
+// Sucht von EOF rückwärts den jüngsten Link-/Unlink-Eintrag je gesuchter Betriebsart und
+// hört auf, sobald alle gefunden sind. Die Laufzeit hängt damit nicht von der Loggröße ab.
+static void findLatestReflectors(const std::string& path, std::map<Mode, ParsedResult>& found,
+                                 const std::vector<Mode>& wanted) {
+    LogParser tmp; // eigener, kurzlebiger Parser (keine Wechselwirkung mit dem Live-Parser)
+    std::vector<ParsedResult> pending;
+    auto missing = [&] {
+        size_t n = 0;
+        for (Mode m : wanted) if (!found.count(m)) ++n;
+        return n;
+    };
+    if (missing() == 0) return;
+
+    scanLinesBackward(path, [&](std::string_view line) {
+        auto res = tmp.processLine(line);
+        tmp.takePending(pending); // erzwungene Enden verwerfen
+        if (res && (res->kind == EventKind::Link || res->kind == EventKind::Unlink) &&
+            std::find(wanted.begin(), wanted.end(), res->mode) != wanted.end() &&
+            !found.count(res->mode)) {
+            res->originalLine = {};
+            found.emplace(res->mode, *res);
+        }
+        return missing() > 0;
+    });
+}
+
+// Setzt die Reflektor-Spalten aus dem jüngsten Eintrag im Log. Nur wenn das heutige Log
+// nichts liefert, wird das des Vortags (ggf. rotiert) herangezogen. Keine Konsolen-Ausgabe.
+static void backfillReflectorsFromFile(const std::string& path, DbWriter& db) {
+    const std::vector<Mode> wanted = reflectorModesFor(path);
+    std::map<Mode, ParsedResult> found;
+
+    findLatestReflectors(path, found, wanted);
+    if (found.size() < wanted.size()) {
+        for (const auto& prev : previousDayLogs(path)) {
+            if (!statFile(prev)) continue;
+            findLatestReflectors(prev, found, wanted);
+            break;
+        }
+    }
+
+    for (const auto& [mode, res] : found) {
+        db.post(res); // schreibt reflector.{fusion,dmr,dstar}
+    }
+}
+
+// ---- Import historischer Logs (--import <dir>) ----
+// Baut lastheard nach einem DB-Verlust oder auf einem frisch installierten Dashboard aus den
+// vorhandenen (auch rotierten und gzip-komprimierten) Logs neu auf. Jede Datei wird mit eigenem
+// Parser-Zustand gelesen, die Dateien verteilen sich auf einen Pool mit Work-Stealing; danach
+// gehen alle Enden in Zeitstempel-Reihenfolge in einer Transaktion in die DB.
+
+// Heutige, rotierte (".1") und komprimierte (".2.gz" ...) Logs der G4KLX-Programme
+static bool isImportLogName(std::string_view n) {
+    if (!starts_with(n, "MMDVM-") && !starts_with(n, "YSFGateway-") && !starts_with(n, "DMRGateway-")) return false;
+    const size_t p = n.rfind(".log");
+    if (p == std::string_view::npos) return false;
+    std::string_view rest = n.substr(p + 4);
+    if (rest.size() >= 3 && rest.substr(rest.size() - 3) == ".gz") rest.remove_suffix(3);
+    if (rest.empty()) return true;
+    if (rest.size() < 2 || rest.front() != '.') return false;
+    return std::all_of(rest.begin() + 1, rest.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Liest eine Datei zeilenweise (ohne \r\n). zlib entpackt .gz-Dateien blockweise beim Lesen
+// und reicht unkomprimierte Dateien unverändert durch. Rückgabe: false bei Lesefehler.
+template <typename F>
+static bool readLinesGz(const std::string& path, F&& onLine) {
+    gzFile gz = gzopen(path.c_str(), "rb");
+    if (!gz) return false;
+    gzbuffer(gz, 128 * 1024);
+
+    std::vector<char> buf(256 * 1024);
+    size_t carry = 0;
+    bool ok = true;
+    for (;;) {
+        if (carry == buf.size()) buf.resize(buf.size() * 2); // Zeile länger als Puffer
+        const int n = gzread(gz, buf.data() + carry, static_cast<unsigned>(buf.size() - carry));
+        if (n < 0) { ok = false; break; }
+        if (n == 0) break;
+
+        const char* base = buf.data();
+        const char* end  = base + carry + static_cast<size_t>(n);
+        const char* p    = base;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!nl) break;
+            std::string_view line(p, static_cast<size_t>(nl - p));
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            onLine(line);
+            p = nl + 1;
+        }
+        carry = static_cast<size_t>(end - p);
+        if (carry > 0 && p != base) std::memmove(buf.data(), p, carry);
+    }
+    // rotierte Dateien sind abgeschlossen: letzte Zeile auch ohne \n übernehmen
+    if (ok && carry > 0) onLine(std::string_view(buf.data(), carry));
+    gzclose(gz);
+    return ok;
+}
+
+struct ImportedFile {
+    std::vector<ParsedResult> ends;   // Enden → lastheard, originalLine ist geleert
+    uint64_t lines = 0;
+    bool ok = false;
+};
+
+// Eine Datei mit eigenem Parser: nur die Enden werden behalten. Am Dateiende noch offene
+// Übertragungen bekommen kein erzwungenes Ende – ihr echtes Ende steht, wenn überhaupt, in
+// der nächsten Datei, und ein Ende ohne Dauer wäre in lastheard nicht von einem echten zu unterscheiden.
+static ImportedFile importLogFile(const std::string& path, const LocalConfig& cfg) {
+    ImportedFile f;
+    LogParser parser(cfg);
+    std::vector<ParsedResult> pending;
+
+    auto keep = [&](ParsedResult r) {
+        if (r.kind != EventKind::End) return;
+        r.originalLine = {};
+        f.ends.push_back(r);
+    };
+
+    f.ok = readLinesGz(path, [&](std::string_view line) {
+        ++f.lines;
+        auto res = parser.processLine(line);
+        parser.takePending(pending);
+        for (const auto& p : pending) keep(p);
+        if (res) keep(*res);
+    });
+    return f;
+}
+
+// Verteilt tasks (nach Aufwand absteigend sortiert) reihum auf je eine Warteschlange pro
+// Thread. Jeder Thread nimmt von vorn aus seiner eigenen (größte zuerst) und stiehlt, wenn
+// sie leer ist, von hinten aus den anderen.
+template <typename F>
+static void runWorkStealing(const std::vector<size_t>& tasks, unsigned threads, F&& run) {
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(tasks.size())));
+    struct Queue {
+        std::mutex mtx;
+        std::deque<size_t> q;
+    };
+    std::vector<Queue> queues(threads);
+    for (size_t i = 0; i < tasks.size(); ++i) queues[i % threads].q.push_back(tasks[i]);
+
+    auto next = [&](unsigned self) -> std::optional<size_t> {
+        {
+            std::lock_guard<std::mutex> lk(queues[self].mtx);
+            if (!queues[self].q.empty()) {
+                const size_t t = queues[self].q.front();
+                queues[self].q.pop_front();
+                return t;
+            }
+        }
+        for (unsigned k = 1; k < threads; ++k) {
+            Queue& victim = queues[(self + k) % threads];
+            std::lock_guard<std::mutex> lk(victim.mtx);
+            if (!victim.q.empty()) {
+                const size_t t = victim.q.back();
+                victim.q.pop_back();
+                return t;
+            }
+        }
+        return std::nullopt;
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            while (auto task = next(t)) run(*task);
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+} // namespace
+
+int runImport(const std::string& dir, const LocalConfig& cfg, Database& database) {
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+
+    std::vector<std::string> files;
+    std::vector<uint64_t> sizes;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = e.path().filename().string();
+        if (!e.is_regular_file(ec) || !isImportLogName(name)) continue;
+        files.push_back(e.path().string());
+        sizes.push_back(e.file_size(ec));
+    }
+    if (ec && files.empty()) {
+        dlog("[IMP ] cannot read ", dir, ": ", ec.message());
+        return 1;
+    }
+    if (files.empty()) {
+        dlog("[IMP ] no log files in ", dir);
+        return 0;
+    }
+
+    // größte Dateien zuerst verteilen, damit am Ende keiner auf eine große Datei wartet
+    // (komprimierte zählen grob zehnfach)
+    std::vector<size_t> order(files.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    auto cost = [&](size_t i) {
+        const bool gz = files[i].size() > 3 && files[i].compare(files[i].size() - 3, 3, ".gz") == 0;
+        return gz ? sizes[i] * 10 : sizes[i];
+    };
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cost(a) > cost(b); });
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<ImportedFile> parsed(files.size());
+    runWorkStealing(order, threads, [&](size_t i) { parsed[i] = importLogFile(files[i], cfg); });
+    const auto t1 = clock::now();
+
+    // alle Enden nach Zeitstempel; bei Gleichstand bleibt die Reihenfolge innerhalb einer Datei
+    uint64_t lines = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!parsed[i].ok) dlog("[IMP ] read error: ", files[i]);
+        lines += parsed[i].lines;
+        total += parsed[i].ends.size();
+    }
+    std::vector<ParsedResult> ends;
+    ends.reserve(total);
+    for (auto& f : parsed) {
+        ends.insert(ends.end(), f.ends.begin(), f.ends.end());
+        std::vector<ParsedResult>().swap(f.ends);
+    }
+    std::stable_sort(ends.begin(), ends.end(),
+                     [](const ParsedResult& a, const ParsedResult& b) { return a.ts < b.ts; });
+
+    size_t skipped = 0;
+    const long inserted = database.importLastHeard(ends, skipped);
+    const auto t2 = clock::now();
+
+    auto ms = [](clock::duration d) { return std::chrono::duration_cast<std::chrono::milliseconds>(d).count(); };
+    dlog("[IMP ] files=", files.size(), " threads=", std::min<size_t>(threads, files.size()),
+         " lines=", lines, " ends=", ends.size(), " parse_ms=", ms(t1 - t0));
+    if (inserted < 0) {
+        dlog("[IMP ] import failed, nothing written");
+        return 1;
+    }
+    dlog("[IMP ] inserted=", inserted, " skipped_existing=", skipped, " load_ms=", ms(t2 - t1));
+    return 0;
+}
+
+// ---- Replay einer Logdatei (--replay <file> --speed <N>x) ----
+// Schickt eine vorhandene Logdatei durch dieselbe Kette wie im Betrieb (LogReader → LogParser
+// → EventMerger → DbWriter), entweder im Originaltakt der Zeitstempel geteilt durch speed oder
+// (speed <= 0) so schnell wie möglich. Die Offsets-Datei bleibt unberührt. Am Ende eine
+// Zusammenfassung mit Durchsatz und Latenz von Zeile gelesen bis Stapel committet.
+int runReplay(const std::string& path, double speed, const LocalConfig& cfg,
+              Database& database, std::chrono::milliseconds window) {
+    using clock = std::chrono::steady_clock;
+    if (!statFile(path)) {
+        dlog("[RPL ] cannot open ", path);
+        return 1;
+    }
+
+    LogParser parser(cfg);
+    EventMerger merger{window};
+    merger.setStreamCount(1);
+    LogReader reader(path);
+
+    // Commit-Zeitpunkte aus dem Writer-Thread: (Ereignisse bis einschließlich, Zeitpunkt)
+    std::mutex commitMtx;
+    std::vector<std::pair<uint64_t, clock::time_point>> commits;
+    DbWriter db(database);
+    db.setCommitHook([&](uint64_t upTo) {
+        const auto now = clock::now();
+        std::lock_guard<std::mutex> lk(commitMtx);
+        commits.emplace_back(upTo, now);
+    });
+
+    // Eine Datei → der Merger gibt in Eingangsreihenfolge frei; die Lesezeit läuft parallel mit
+    std::deque<clock::time_point> heldSince;
+    std::vector<clock::time_point> postedAt;   // je gepostetem Ereignis: Zeitpunkt der Zeile
+    uint64_t queueFull = 0;
+    auto post = [&](const ParsedResult& r) {
+        while (!db.tryPost(r)) { ++queueFull; db.flush(); std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        postedAt.push_back(heldSince.front());
+        heldSince.pop_front();
+        return true;
+    };
+
+    const auto start = clock::now();
+    std::optional<std::chrono::system_clock::time_point> firstTs;
+    uint64_t lines = 0;
+    std::vector<ParsedResult> pending;
+
+    reader.readFrom(0, [&](std::string_view line) {
+        ++lines;
+        if (speed > 0) {
+            if (auto ts = parser.timestampOf(line)) {
+                if (!firstTs) firstTs = ts;
+                const auto target = start + std::chrono::duration_cast<clock::duration>((*ts - *firstTs) / speed);
+                // bis zur Zeile Fälliges schreiben lassen, dann warten
+                while (clock::now() < target) {
+                    merger.drain(post);
+                    db.flush();
+                    const int due = merger.msUntilDue();
+                    auto until = target;
+                    if (due >= 0) until = std::min(until, clock::now() + std::chrono::milliseconds(due));
+                    std::this_thread::sleep_until(until);
+                }
+            }
+        }
+
+        const auto lineAt = clock::now();
+        auto res = parser.processLine(line);
+        parser.takePending(pending);
+        for (const auto& p : pending) { heldSince.push_back(lineAt); merger.push(0, p); }
+        if (res) { heldSince.push_back(lineAt); merger.push(0, *res); }
+        merger.drain(post);
+        if (speed > 0) db.flush(); // wie ein Lese-Tick je Zeile im Echtzeitbetrieb
+    });
+
+    while (!merger.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, merger.msUntilDue())));
+        merger.drain(post);
+    }
+    db.flush();
+    const auto read = clock::now();
+    while (db.written() < postedAt.size()) {
+        db.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto end = clock::now();
+
+    // Latenz je Ereignis: erster Commit, der es enthält
+    std::vector<double> latMs;
+    latMs.reserve(postedAt.size());
+    {
+        std::lock_guard<std::mutex> lk(commitMtx);
+        size_t c = 0;
+        for (size_t i = 0; i < postedAt.size(); ++i) {
+            while (c < commits.size() && commits[c].first <= i) ++c;
+            if (c == commits.size()) break;
+            latMs.push_back(std::chrono::duration<double, std::milli>(commits[c].second - postedAt[i]).count());
+        }
+    }
+    std::sort(latMs.begin(), latMs.end());
+    auto pct = [&](double q) {
+        if (latMs.empty()) return 0.0;
+        return latMs[std::min(latMs.size() - 1, static_cast<size_t>(q * static_cast<double>(latMs.size())))];
+    };
+
+    const double secs = std::max(1e-9, std::chrono::duration<double>(end - start).count());
+    dlog("[RPL ] ", path, " speed=", speed > 0 ? fmtNum(speed) + "x" : std::string("max"));
+    dlog("[RPL ] lines=", lines, " events=", postedAt.size(), " elapsed_s=", fmtNum(secs),
+         " read_s=", fmtNum(std::chrono::duration<double>(read - start).count()));
+    dlog("[RPL ] lines_per_s=", fmtNum(lines / secs), " events_per_s=", fmtNum(postedAt.size() / secs),
+         " batches=", db.batches(), " queue_full=", queueFull);
+    dlog("[RPL ] latency_ms p50=", fmtNum(pct(0.50)), " p99=", fmtNum(pct(0.99)),
+         " max=", fmtNum(latMs.empty() ? 0.0 : latMs.back()));
+    return 0;
+}
+
+StatusOptions parseStatusOptions(int argc, char** argv, int first) {
+    StatusOptions o;
+    for (int i = first; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        if (a == "--reorder-ms" && i + 1 < argc) {
+            o.reorderMs = std::max(0, std::atoi(argv[++i]));
+        } else if (a == "--import" && i + 1 < argc) {
+            o.importDir = argv[++i];
+        } else if (a == "--replay" && i + 1 < argc) {
+            o.replayFile = argv[++i];
+        } else if (a == "--speed" && i + 1 < argc) {
+            const std::string_view v = argv[++i];
+            o.speed = (v == "max") ? 0.0 : std::max(0.0, std::atof(argv[i])); // "10x" → 10
+        } else if (a == "--spool-mb" && i + 1 < argc) {
+            o.spoolBytes = static_cast<size_t>(std::max(0, std::atoi(argv[++i]))) << 20;
+        } else if (a.size() > 2 && a.substr(0, 2) == "--") {
+            // Tippfehler wie "--spool-mbs 8" sonst als Logpfad beobachtet
+            static constexpr std::string_view kWithValue[] = {"--reorder-ms", "--import", "--replay",
+                                                              "--speed", "--spool-mb"};
+            const bool known = std::find(std::begin(kWithValue), std::end(kWithValue), a) != std::end(kWithValue);
+            o.error = (known ? "unvollständige Option: " : "unbekannte Option: ") + std::string(a);
+            break;
+        } else {
+            o.paths.emplace_back(a);
+        }
+    }
+    return o;
+}
+
+void printStatusUsage(const char* prog, const std::string& error) {
+    std::cerr << error << "\n"
+              << "Aufruf: " << prog << " [Optionen] [Logdatei|Verzeichnis ...]\n"
+              << "  --reorder-ms <ms>  max. Verzögerung für die zeitliche Sortierung (Default 250)\n"
+              << "  --import <dir>     alle Logs im Verzeichnis einmalig in lastheard laden\n"
+              << "  --replay <file>    Logdatei einmal durch Parser und DB-Writer schicken\n"
+              << "  --speed <N>x       Tempo beim Replay (Default 1x, \"max\" = ohne Pause)\n"
+              << "  --spool-mb <N>     Größe des Spools für Ausfälle der DB (Default 16, 0 = kein Spool)\n";
+}
+
+// ---- StatusTail ----
+
+StatusTail::StatusTail(const LocalConfig& cfg, Database& database, const StatusOptions& opt)
+    : argPaths_(opt.paths), parser_(cfg),
+      db_(database, openSpool(spool_, opt.spoolBytes)),   // alle SQL-Zugriffe laufen im Writer-Thread
+      merger_{std::chrono::milliseconds(opt.reorderMs)},
+      offsets_(loadOffsets()), checkpointed_(offsets_) {}
+
+int StatusTail::tick() {
+    std::vector<std::string> paths;
+    if (argPaths_.empty()) {
+        paths = defaultLogPaths();
+    } else {
+        // Argumente expandieren: Verzeichnisse -> 3 Log-Dateien; Dateien -> unverändert
+        for (const auto& ap : argPaths_) {
+            if (std::filesystem::is_directory(ap)) {
+                auto v = logsForDir(ap);
+                paths.insert(paths.end(), v.begin(), v.end());
+            } else {
+                paths.push_back(ap);
+            }
+        }
+    }
+
+    // vor dem Lesen registrieren, damit zwischen Lesen und Warten nichts verloren geht
+    // (Dateien des Vortags liegen im selben Verzeichnis und sind damit mit beobachtet)
+    const bool watched = watcher_.watch(paths);
+    merger_.setStreamCount(paths.size());
+
+    // Einmalig beim Start: Reflektor-Spalten aus dem Log, danach die Lesepositionen festlegen
+    if (!didBackfill_) {
+        for (const auto& p : paths) {
+            backfillReflectorsFromFile(p, db_);   // ändert keine Leseposition
+
+            auto st = statFile(p);
+            if (!st) continue;
+            // Gespeicherte Position derselben Datei: dort weiterlesen, was während des Stillstands
+            // geschrieben wurde, liest der Tail-Modus nach (auch ein copytruncate dazwischen).
+            auto it = offsets_.find(p);
+            if (it != offsets_.end() && it->second.inode == st->inode) continue;
+            // unbekannte oder ersetzte Datei: ab EOF im Tail-Modus weitermachen
+            offsets_[p] = OffsetEntry{st->inode, static_cast<uint64_t>(st->size)};
+        }
+        db_.checkpoint(offsets_);
+        db_.flush();
+        checkpointed_ = offsets_;
+        didBackfill_ = true;
+    }
+
+    bool anyProcessed = false;
+
+    // Nach dem Datumswechsel: Dateien des Vortags weiterlesen, bis sie zur Ruhe kommen
+    // (Gateways schreiben ggf. noch Sekunden nach Mitternacht hinein).
+    // Eigener Stream hinter denen der aktuellen Pfade, sonst mischt der Merger die alte Datei
+    // in die FIFO-Reihenfolge der neuen.
+    for (const auto& old : prevPaths_) {
+        if (std::find(paths.begin(), paths.end(), old) != paths.end()) continue;
+        if (!offsets_.count(old) || draining_.count(old)) continue; // nie gelesen / läuft schon aus
+        StreamId stream = static_cast<StreamId>(paths.size());
+        for (bool used = true; used; ) {
+            used = false;
+            for (const auto& d : draining_) if (d.second.stream == stream) { used = true; ++stream; break; }
+        }
+        draining_.emplace(old, Draining{stream, 0, std::chrono::steady_clock::now()});
+    }
+    prevPaths_ = paths;
+
+    // Leser für nicht mehr beobachtete Pfade schließen
+    for (auto it = readers_.begin(); it != readers_.end(); ) {
+        if (std::find(paths.begin(), paths.end(), it->first) == paths.end() && !draining_.count(it->first))
+            it = readers_.erase(it);
+        else ++it;
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (tailOne(paths[i], static_cast<StreamId>(i))) anyProcessed = true; // Reihenfolge der Pfade ist fest
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = draining_.begin(); it != draining_.end(); ) {
+        Draining& d = it->second;
+        auto size = tailOne(it->first, d.stream);
+        if (size) anyProcessed = true;
+        if (size && *size != d.size) { d.size = *size; d.changed = now; }
+        if (!size || now - d.changed > kQuiescent) {
+            // noch offene Übertragungen der alten Datei beenden, dann gibt sie nichts mehr
+            std::vector<ParsedResult> ends;
+            parser_.flushAtEof({}, d.stream);
+            parser_.takePending(ends);
+            for (const auto& e : ends) { printResult(e); merger_.push(d.stream, e); }
+            merger_.closeStream(d.stream);
+            offsets_.erase(it->first);
+            readers_.erase(it->first);
+            it = draining_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (tail_.truncations + tail_.rotations != tailReported_) {
+        tailReported_ = tail_.truncations + tail_.rotations;
+        dlog("[TAIL] truncations=", tail_.truncations, " rotations=", tail_.rotations,
+             " recovered_bytes=", tail_.recoveredBytes, " lost_bytes=", tail_.lostBytes);
+    }
+
+    // Queue voll: Ereignisse bleiben im Merger, statt verworfen zu werden
+    const bool drained = merger_.drain([&](const ParsedResult& r) { return db_.tryPost(r); });
+
+    // Lesepositionen erst sichern, wenn nichts mehr im Merger steckt; gespeichert werden
+    // sie vom Writer nach dem Commit, damit ein Absturz weder Zeilen verliert noch doppelt schreibt.
+    if (anyProcessed && merger_.empty() && offsets_ != checkpointed_) {
+        db_.checkpoint(offsets_);
+        checkpointed_ = offsets_;
+    }
+    db_.flush();
+
+    // Schlafen, bis eine der Dateien wächst oder angelegt wird. Kann ein Verzeichnis
+    // (noch) nicht beobachtet werden, wie bisher im Sekundentakt nachsehen.
+    // Hält der Merger noch Ereignisse zurück, höchstens bis zu deren Freigabe.
+    // Bei voller Queue in kurzen Abständen nachsehen, ob der Writer wieder Platz hat.
+    if (!drained) return kBackpressureMs;
+    const int due = merger_.msUntilDue();
+    return watched ? due : (due < 0 ? 1000 : std::min(due, 1000));
+}
+
+EventSpool* StatusTail::openSpool(EventSpool& spool, size_t bytes) {
+    if (bytes && !spool.open(spoolPath(), bytes)) dlog("[SPL ] no spool, events are lost while the database is down");
+    return spool.ok() ? &spool : nullptr;
+}
+
+std::optional<uint64_t> StatusTail::tailOne(const std::string& p, StreamId stream) {
+    auto st = statFile(p);
+    if (!st) {
+        return std::nullopt;
+    }
+
+    uint64_t lastInode = 0, lastOffset = 0;
+    const bool known = offsets_.count(p) > 0;
+    if (known) {
+        lastInode  = offsets_[p].inode;
+        lastOffset = offsets_[p].offset;
+    }
+    LogReader& reader = readers_.try_emplace(p, p).first->second;
+    const uint64_t size = static_cast<uint64_t>(st->size);
+    // hinter der gespeicherten Position stand beim letzten Lesen mindestens so viel
+    const uint64_t unread = reader.sizeAtLastRead() > lastOffset ? reader.sizeAtLastRead() - lastOffset : 0;
+    const std::string copy = p + ".1";
+
+    if (known && st->inode == lastInode && (size < lastOffset || reader.replacedBefore(lastOffset))) {
+        // copytruncate, auch wenn die Datei seitdem schon wieder über lastOffset gewachsen ist:
+        // was zwischen letztem Lesen und Kopie geschrieben wurde, steht in "<log>.1"
+        tail_.truncations++;
+        auto cst = statFile(copy);
+        readRotated(p, copy, cst && static_cast<uint64_t>(cst->size) >= lastOffset, lastOffset, unread,
+                    stream, "truncated");
+        lastOffset = 0;
+    } else if (known && st->inode != lastInode) {
+        // umbenannt und neu angelegt: der Rest steht in "<log>.1", wenn dort die alte Datei liegt
+        tail_.rotations++;
+        auto cst = statFile(copy);
+        readRotated(p, copy, cst && cst->inode == lastInode, lastOffset, unread, stream, "rotated");
+        lastOffset = 0;
+    } else if (!known) {
+        // neue Datei (z. B. nach dem Datumswechsel): von vorn lesen.
+        // Beim Start stehen vorhandene Dateien bereits auf der gespeicherten Position oder EOF.
+        lastOffset = 0;
+    }
+
+    const uint64_t newOffset = processFileFromOffset(reader, parser_, merger_, lastOffset, stream, pending_);
+    offsets_[p] = OffsetEntry{st->inode, newOffset};
+    return static_cast<uint64_t>(st->size);
+}
+
+void StatusTail::readRotated(const std::string& p, const std::string& copy, bool usable, uint64_t from,
+                             uint64_t unread, StreamId stream, const char* what) {
+    if (!usable) {
+        tail_.lostBytes += unread;
+        // ohne Kopie ist nur bekannt, was beim letzten Lesen schon hinter from stand
+        dlog("[TAIL] ", p, " ", what, ", no usable ", copy, ", lost at least ", unread,
+             " bytes plus anything written since the last read");
+        return;
+    }
+    LogReader rotated(copy);
+    const uint64_t end = processFileFromOffset(rotated, parser_, merger_, from, stream, pending_);
+    // eine unvollständige letzte Zeile in der Kopie wird nicht mehr fertig
+    const uint64_t partial = rotated.sizeAtLastRead() > end ? rotated.sizeAtLastRead() - end : 0;
+    tail_.recoveredBytes += end - from;
+    tail_.lostBytes += partial;
+    dlog("[TAIL] ", p, " ", what, ", recovered ", end - from, " bytes from ", copy,
+         partial ? ", lost an unterminated line of " : "", partial ? std::to_string(partial) : std::string());
+}
+
+} // namespace status
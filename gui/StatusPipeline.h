@@ -0,0 +1,1082 @@
+/*
+StatusPipeline.h
+================
+
+Die Log-Auswertung von mmdvm-status als Bibliothek: LogParser, Datenbank-Writer,
+Zusammenführen und Lesen der Logdateien (StatusTail) sowie Import und Replay.
+Gebaut als StatusPipeline.o und gemeinsam benutzt von mmdvm-status (mmdvm_status.cpp),
+DVconfig --with-status (parser/StatusService.cpp) und den Programmen in bench/.
+
+Alles liegt im Namespace status, damit es neben den Klassen von DVconfig (Database ...)
+in einem Programm stehen kann. Hilfsfunktionen ohne Nutzer außerhalb bleiben in
+StatusPipeline.cpp.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <mysql/mysql.h>   // libmariadb-dev-compat
+#include "DbConn.h"
+
+namespace status {
+
+template <typename... Args>
+void dlog(Args&&... args) {
+    (std::cerr << ... << args) << '\n';
+}
+
+// Zahl mit höchstens drei Nachkommastellen, ohne überflüssige Nullen
+std::string fmtNum(double v);
+
+// String mit fester Kapazität ohne Heap-Allokation; längere Werte werden abgeschnitten.
+template <size_t N>
+struct InlineStr {
+    char     buf[N];
+    uint8_t  len = 0;
+    static_assert(N < 256, "InlineStr: Länge passt nicht in uint8_t");
+
+    InlineStr() = default;
+    InlineStr(std::string_view v) { assign(v); }
+
+    InlineStr& operator=(std::string_view v) { return assign(v); }
+    InlineStr& assign(std::string_view v) { len = 0; return append(v); }
+    InlineStr& append(std::string_view v) {
+        size_t n = std::min(v.size(), N - len);
+        std::memcpy(buf + len, v.data(), n);
+        len = static_cast<uint8_t>(len + n);
+        return *this;
+    }
+
+    std::string_view view() const { return std::string_view(buf, len); }
+    operator std::string_view() const { return view(); }
+    bool empty() const { return len == 0; }
+
+    friend bool operator==(const InlineStr& a, std::string_view b) { return a.view() == b; }
+    friend bool operator!=(const InlineStr& a, std::string_view b) { return a.view() != b; }
+    friend std::ostream& operator<<(std::ostream& os, const InlineStr& a) { return os << a.view(); }
+};
+
+using CallsignStr = InlineStr<20>;   // wie VARCHAR(20) in status/lastheard
+using InfoStr     = InlineStr<64>;   // wie VARCHAR(64) in reflector
+
+// ---- Typisiertes Ereignismodell ----
+// Texte gibt es nur an der SQL-/Konsolengrenze (modeName, kindName, sourceName).
+// Die switch-Anweisungen haben bewusst kein default, damit -Wswitch eine neue Betriebsart meldet.
+
+// Betriebsarten aus "Mode set to <Mode>" (MMDVMHost)
+enum class Mode : uint8_t { Unknown, Idle, DStar, DMR, YSF, P25, NXDN, POCSAG, FM, M17, Lockout, Error, Quit };
+
+enum class EventKind : uint8_t {
+    Start,       // Übertragung beginnt
+    End,         // Übertragung endet (auch erzwungen)
+    ModeChange,  // "Mode set to ..."
+    Link,        // Reflektor/Master verbunden, Name in info
+    Unlink       // Reflektor getrennt
+};
+
+enum class Source : uint8_t { None, RF, NET };
+
+constexpr std::string_view modeName(Mode m) {
+    switch (m) {
+        case Mode::Unknown: return "Unknown";
+        case Mode::Idle:    return "Idle";
+        case Mode::DStar:   return "D-Star";
+        case Mode::DMR:     return "DMR";
+        case Mode::YSF:     return "YSF";
+        case Mode::P25:     return "P25";
+        case Mode::NXDN:    return "NXDN";
+        case Mode::POCSAG:  return "POCSAG";
+        case Mode::FM:      return "FM";
+        case Mode::M17:     return "M17";
+        case Mode::Lockout: return "Lockout";
+        case Mode::Error:   return "Error";
+        case Mode::Quit:    return "Quit";
+    }
+    return "Unknown";
+}
+
+Mode modeFromName(std::string_view s);
+
+constexpr std::string_view kindName(EventKind k) {
+    switch (k) {
+        case EventKind::Start:      return "Start";
+        case EventKind::End:        return "Ende";
+        case EventKind::ModeChange: return "Mode";
+        case EventKind::Link:
+        case EventKind::Unlink:     return "Info";
+    }
+    return "";
+}
+
+constexpr std::string_view sourceName(Source s) {
+    switch (s) {
+        case Source::None: return "-";
+        case Source::RF:   return "RF";
+        case Source::NET:  return "NET";
+    }
+    return "-";
+}
+
+// ---- Internierte Rufzeichen ----
+// Jedes Rufzeichen wird einmal abgelegt und danach nur noch über einen 32-Bit-Handle
+// weitergereicht (0 = kein Rufzeichen). Einträge werden nie verschoben oder gelöscht;
+// str() ist ohne Lock lesbar, intern() ist über einen Mutex serialisiert.
+using CallsignId = uint32_t;
+
+class CallsignTable {
+public:
+    CallsignId intern(std::string_view cs);
+
+    std::string_view str(CallsignId id) const {
+        if (id == 0 || id >= count_.load(std::memory_order_acquire)) return {};
+        return chunks_[id / kChunk][id % kChunk].view();
+    }
+
+private:
+    static constexpr uint32_t kChunk = 256;
+    static constexpr uint32_t kMaxChunks = 4096;
+
+    std::mutex mtx_;
+    std::unique_ptr<CallsignStr[]> chunks_[kMaxChunks];
+    std::atomic<uint32_t> count_{1}; // Handle 0 ist reserviert
+    std::unordered_map<std::string_view, CallsignId> index_;
+};
+
+// Die eine Tabelle des Prozesses
+CallsignTable& callsigns();
+
+struct ParsedResult {
+    std::string_view originalLine; // zeigt in den Lesepuffer, nur bis zur nächsten Zeile gültig
+    EventKind kind = EventKind::Start;
+    Mode mode = Mode::Unknown;     // D-Star, YSF, DMR, oder neue Betriebsart
+    Source source = Source::None;
+    CallsignId callsign = 0;       // 0 = kein Rufzeichen
+    std::optional<int> dgId;
+    std::optional<int> slot;
+    std::optional<double> durationSec;
+    std::optional<double> berPct;
+    InfoStr info;                  // Reflektor/Master bei Link, z. B. "DCS001 R"
+    std::chrono::system_clock::time_point ts{}; // Zeitstempel der Logzeile (ohne: Zeitpunkt des Lesens)
+};
+
+struct TransmissionState {
+    Mode mode;                     // D-Star / YSF / DMR
+    Source source;                 // RF / NET
+    CallsignId callsign;
+    std::optional<int> dgId;
+    std::optional<int> slot;
+    std::chrono::system_clock::time_point startTp;
+};
+
+// Logdatei, aus der eine Zeile stammt (MMDVM, YSFGateway, DMRGateway, ...)
+using StreamId = uint8_t;
+
+struct LocalConfig {
+    std::string callsign;
+    int         duplex = 0;                 // 0=simplex (default), 1=duplex
+    uint64_t    rxFrequency = 0;            // Hz, z.B. 431850000
+    uint64_t    txFrequency = 0;            // Hz, z.B. 439450000
+    double      latitude  = std::numeric_limits<double>::quiet_NaN();
+    double      longitude = std::numeric_limits<double>::quiet_NaN();
+    std::string location;                   // z.B. "myCity"
+    std::string description;                // z.B. "myCountry"
+};
+
+// Liest Callsign, Duplex, RX/TX-Frequenzen, GPS und Location/Description aus /etc/MMDVMHost.ini
+LocalConfig readLocalConfig();
+
+// Ein gültiges Callsign muss mindestens zwei Buchstaben und eine Zahl enthalten.
+bool isValidCallsign(std::string_view cs);
+
+struct OffsetEntry {
+    uint64_t inode = 0;
+    uint64_t offset = 0;
+
+    bool operator==(const OffsetEntry& o) const { return inode == o.inode && offset == o.offset; }
+    bool operator!=(const OffsetEntry& o) const { return !(*this == o); }
+};
+
+// ---- Parser ----
+// Jede Zeile wird einmal anhand ihres führenden Schlüsselworts ("Mode set to", "D-Star,",
+// "YSF,", "DMR Slot") klassifiziert, die Felder werden danach von Hand gelesen.
+class LogParser {
+public:
+    explicit LogParser(const LocalConfig& lc = {})
+        : localCallsign(lc.callsign),
+          ignoreSelfOnNET(lc.duplex == 1) {
+    }
+
+    // Gibt bei relevanter Zeile ein ParsedResult zurück; sonst nullopt.
+    // stream kennzeichnet die Logdatei; offene Übertragungen werden je
+    // (stream, Betriebsart, Slot) geführt und beeinflussen sich nicht gegenseitig.
+    std::optional<ParsedResult> processLine(std::string_view line, StreamId stream = 0);
+
+    // Zeitstempel einer Logzeile ohne sie auszuwerten (Tempo beim Replay)
+    std::optional<std::chrono::system_clock::time_point> timestampOf(std::string_view line) {
+        return extractTimestamp(line);
+    }
+
+    // Rufzeichen ohne Suffix: "DL1ABC  /ID51" → "DL1ABC"
+    static std::string_view sanitizeCallsign(std::string_view in);
+
+    // Am Ende der Datei aufrufen, um offene Übertragungen der Datei sauber zu schließen (falls gewünscht).
+    // Die Enden (ohne Dauer/BER) liegen danach in takePending().
+    void flushAtEof(std::string_view lastLine, StreamId stream = 0) {
+        stream_ = stream;
+        endStreamSessions(lastLine, std::nullopt);
+    }
+
+    // Abruf der ggf. aufgelaufenen "erzwungenen Ende"-Ergebnisse vor einem Start.
+    // Tauscht die Puffer statt zu kopieren; beide behalten ihre Kapazität. Eine Zeile beendet
+    // höchstens alle Sessions, mit dieser Reserve allokiert danach keine Zeile mehr.
+    void takePending(std::vector<ParsedResult>& out) {
+        out.clear();
+        out.swap(pending_);
+        pending_.reserve(kMaxSessions);
+    }
+
+private:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    std::string localCallsign;
+    bool ignoreSelfOnNET = false;
+    std::vector<uint8_t> selfMemo_; // je CallsignId: 0 = ungeprüft, 1 = eigenes, 2 = fremdes
+
+    // Offene Übertragungen, flach statt Map: es sind nur eine Handvoll
+    // (z. B. beide DMR-Zeitschlitze im Duplex-Betrieb).
+    struct Session {
+        StreamId stream;
+        uint8_t  slot;                 // 0 = ohne Zeitschlitz
+        TransmissionState st;
+    };
+    static constexpr size_t kMaxSessions = 16;
+    Session sessions_[kMaxSessions];
+    size_t  sessionCount_ = 0;
+    StreamId stream_ = 0;              // Logdatei der aktuellen Zeile
+
+    std::vector<ParsedResult> pending_;
+
+    // Zeitstempel-Cache: Epoche (UTC) des zuletzt gesehenen Datums "YYYY-MM-DD"
+    char    tsCacheDate_[10] = {};
+    int64_t tsCacheDayEpoch_ = 0;
+    bool    tsCacheValid_ = false;
+
+    // Erkennung der einzelnen Meldungen; ts ist der Zeitstempel der Zeile
+    std::optional<ParsedResult> parseLine(std::string_view line, const std::optional<TimePoint>& ts);
+    std::optional<ParsedResult> parseHead(std::string_view line, const std::optional<TimePoint>& ts,
+                                          std::string_view body);
+    std::optional<ParsedResult> parseTransmission(std::string_view line, const std::optional<TimePoint>& ts,
+                                                  std::string_view body);
+    std::optional<ParsedResult> parseElsewhere(std::string_view line, const std::optional<TimePoint>& ts,
+                                               std::string_view body);
+    std::optional<ParsedResult> parseDStar(std::string_view line, const std::optional<TimePoint>& ts,
+                                           std::string_view body);
+    std::optional<ParsedResult> parseYSF(std::string_view line, const std::optional<TimePoint>& ts,
+                                         std::string_view body);
+    std::optional<ParsedResult> parseDMR(std::string_view line, const std::optional<TimePoint>& ts,
+                                         std::string_view body);
+
+    std::optional<TimePoint> extractTimestamp(std::string_view line);
+
+    Session* findSession(Mode mode, const std::optional<int>& slot);
+    void closeSession(Session* s) { *s = sessions_[--sessionCount_]; }
+
+    // Offene Übertragungen der aktuellen Logdatei erzwungen beenden (nach pending_);
+    // mit keep bleiben die Sessions dieser Betriebsart offen.
+    void endStreamSessions(std::string_view line, const std::optional<TimePoint>& ts,
+                           Mode keep = Mode::Unknown);
+
+    // Eigenes Rufzeichen (mit optionalem -Suffix)? Das Ergebnis wird je Handle gemerkt.
+    bool isSelf(CallsignId id);
+
+    std::optional<ParsedResult> handleStart(std::string_view line, const std::optional<TimePoint>& ts,
+                                            Mode mode, Source source, std::string_view callsign,
+                                            std::optional<int> dgId, std::optional<int> slotId = std::nullopt);
+    std::optional<ParsedResult> handleEnd(std::string_view line, const std::optional<TimePoint>& ts,
+                                          Mode mode, Source source, std::string_view callsign,
+                                          std::optional<int> dgId, std::optional<double> durationSec,
+                                          std::optional<double> berPct, std::optional<int> slotId = std::nullopt);
+};
+
+// ---- Prepared Statements mit festen Bind-Puffern ----
+// Jeder Parameter besitzt seinen Puffer samt Länge/NULL-Flag. Gebunden wird einmal nach
+// prepare(); execute() kopiert nur noch die Werte in die vorhandenen Puffer.
+// Keine Heap-Allokation pro Aufruf, nichts bleibt liegen.
+template <size_t N>
+struct StrParam {
+    char buf[N];
+    unsigned long len = 0;
+    my_bool is_null = 1;
+
+    void bind(MYSQL_BIND& b) {
+        b.buffer_type = MYSQL_TYPE_STRING;
+        b.buffer = buf;
+        b.buffer_length = N;
+        b.length = &len;
+        b.is_null = &is_null;
+    }
+    void set(std::string_view v) {
+        len = static_cast<unsigned long>(std::min(v.size(), N));
+        std::memcpy(buf, v.data(), len);
+        is_null = 0;
+    }
+    void set(const std::optional<std::string_view>& v) {
+        if (v) set(*v); else { len = 0; is_null = 1; }
+    }
+};
+
+struct IntParam {
+    long long v = 0;
+    my_bool is_null = 1;
+
+    void bind(MYSQL_BIND& b) {
+        b.buffer_type = MYSQL_TYPE_LONGLONG;
+        b.buffer = &v;
+        b.is_null = &is_null;
+    }
+    void set(const std::optional<int>& o) { v = o.value_or(0); is_null = o ? 0 : 1; }
+};
+
+struct DoubleParam {
+    double v = 0.0;
+    my_bool is_null = 1;
+
+    void bind(MYSQL_BIND& b) {
+        b.buffer_type = MYSQL_TYPE_DOUBLE;
+        b.buffer = &v;
+        b.is_null = &is_null;
+    }
+    void set(const std::optional<double>& o) { v = o.value_or(0.0); is_null = o ? 0 : 1; }
+};
+
+struct BoolParam {
+    signed char v = 0;
+
+    void bind(MYSQL_BIND& b) {
+        b.buffer_type = MYSQL_TYPE_TINY;
+        b.buffer = &v;
+    }
+    void set(bool on) { v = on ? 1 : 0; }
+};
+
+// Statement mit den Parametertypen P... je Zeile; rows > 1 für mehrzeilige INSERTs.
+// Nicht kopierbar, da die Bind-Puffer per Adresse an die Client-Lib gehen.
+template <typename... P>
+class PreparedStmt {
+public:
+    static constexpr size_t kCols = sizeof...(P);
+
+    PreparedStmt() = default;
+    ~PreparedStmt() { close(); }
+    PreparedStmt(const PreparedStmt&) = delete;
+    PreparedStmt& operator=(const PreparedStmt&) = delete;
+
+    bool prepare(MYSQL* conn, std::string_view sql, const char* what, size_t rows = 1) {
+        close();
+        what_ = what;
+        rows_.resize(rows);
+        binds_.assign(rows * kCols, MYSQL_BIND{});
+
+        st_ = mysql_stmt_init(conn);
+        if (!st_ || mysql_stmt_prepare(st_, sql.data(), (unsigned long)sql.size()) != 0) {
+            dlog("[DB  ] prepare ", what_, " failed: ", st_ ? mysql_stmt_error(st_) : mysql_error(conn));
+            close();
+            return false;
+        }
+        for (size_t r = 0; r < rows; ++r) bindRow(r, std::index_sequence_for<P...>{});
+        if (mysql_stmt_bind_param(st_, binds_.data()) != 0) {
+            dlog("[DB  ] bind ", what_, " failed: ", mysql_stmt_error(st_));
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (st_) { mysql_stmt_close(st_); st_ = nullptr; }
+    }
+
+    bool ok() const { return st_ != nullptr; }
+    size_t rows() const { return rows_.size(); }
+
+    // Werte für Zeile r setzen (Reihenfolge wie P...)
+    template <typename... A>
+    void set(size_t r, const A&... args) {
+        static_assert(sizeof...(A) == kCols, "PreparedStmt::set: falsche Parameterzahl");
+        setRow(rows_[r], std::index_sequence_for<P...>{}, args...);
+    }
+
+    bool execute() {
+        if (!st_) return false;
+        if (mysql_stmt_execute(st_) != 0) {
+            dlog("[DB  ] exec ", what_, " failed: ", mysql_stmt_error(st_));
+            return false;
+        }
+        return true;
+    }
+
+    // Zeilen, die das letzte execute() geschrieben hat (bei INSERT IGNORE ohne die übersprungenen)
+    uint64_t affectedRows() const { return st_ ? mysql_stmt_affected_rows(st_) : 0; }
+
+    // einzeiliges Statement: setzen + ausführen
+    template <typename... A>
+    bool execute(const A&... args) {
+        if (!st_) return false;
+        set(0, args...);
+        return execute();
+    }
+
+private:
+    MYSQL_STMT* st_ = nullptr;
+    const char* what_ = "";
+    std::vector<std::tuple<P...>> rows_;   // Größe ändert sich nur in prepare()
+    std::vector<MYSQL_BIND> binds_;
+
+    template <size_t... I>
+    void bindRow(size_t r, std::index_sequence<I...>) {
+        (std::get<I>(rows_[r]).bind(binds_[r * kCols + I]), ...);
+    }
+    template <size_t... I, typename... A>
+    static void setRow(std::tuple<P...>& row, std::index_sequence<I...>, const A&... args) {
+        (std::get<I>(row).set(args), ...);
+    }
+};
+
+// ---- Datenbank (lastheard, status, reflector) ----
+class Database {
+public:
+    explicit Database(std::string socket = "/run/mysqld/mysqld.sock");
+    ~Database() { db_.close(); }
+
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+
+    // Verbindung herstellen, falls nötig; gepingt wird nur nach längerer Ruhe (DbConn)
+    bool ensure_conn() { return db_.get() != nullptr; }
+
+    // Zähler für Pings, Wiederverbindungen und Wiederholungen
+    const DbConn& dbConn() const { return db_; }
+
+    // Zeitpunkt der Logzeile (UTC) als Unix-Sekunden für FROM_UNIXTIME(?). Die DATETIME-Spalten
+    // von status und reflector haben keine Nachkommastellen; dort würde 12:34:59.6 auf 12:35:00
+    // gerundet, deshalb ganze Sekunden (abgeschnitten wie die Sekunde im Log).
+    static double unixSeconds(std::chrono::system_clock::time_point tp) {
+        return static_cast<double>(std::chrono::floor<std::chrono::seconds>(tp).time_since_epoch().count());
+    }
+    // Mit Millisekunden für lastheard.ts (DATETIME(3))
+    static double unixSecondsMs(std::chrono::system_clock::time_point tp) {
+        return std::chrono::floor<std::chrono::milliseconds>(tp).time_since_epoch().count() / 1000.0;
+    }
+
+    // ---- High-level Actions ----
+    bool upsertStatus(Mode mode, CallsignId callsign, const std::optional<int>& dgid,
+                      const std::optional<int>& slot, Source source, bool active,
+                      const std::optional<double>& ber, const std::optional<double>& duration,
+                      std::chrono::system_clock::time_point when);
+
+    // Mehrzeiliges INSERT in lastheard, je Statement bis zu kLastHeardRows Zeilen.
+    // Schon vorhandene Ereignisse (uniq_event) werden übersprungen; inserted zählt die neuen.
+    bool insertLastHeard(const ParsedResult* rows, size_t n, uint64_t* inserted = nullptr);
+
+    bool setReflectorDStar(std::string_view value, std::chrono::system_clock::time_point when) {
+        return st_upsert_reflector_dstar.execute(value, unixSeconds(when));
+    }
+    bool setReflectorFusion(std::string_view value, std::chrono::system_clock::time_point when) {
+        return st_upsert_reflector_fusion.execute(value, unixSeconds(when));
+    }
+    bool setReflectorDMR(std::string_view value, std::chrono::system_clock::time_point when) {
+        return st_upsert_reflector_dmr.execute(value, unixSeconds(when));
+    }
+
+    // Schreibt einen Stapel Ereignisse in einer Transaktion:
+    //  - alle Enden als mehrzeiliges INSERT in lastheard (Reihenfolge bleibt erhalten)
+    //  - status ist eine einzige Zeile → nur der letzte Zustand des Stapels wird geschrieben
+    //  - je Reflektor-Spalte nur der letzte Wert
+    // Rückgabe false: DB nicht erreichbar, nichts geschrieben (der Aufrufer legt den Stapel in
+    // den Spool). Ein SQL-Fehler bei bestehender Verbindung verwirft den Stapel wie bisher;
+    // die Ereignisse zählt rolledBack().
+    bool applyBatch(const ParsedResult* ev, size_t n);
+
+    // Ereignisse, die applyBatch() nach einem SQL-Fehler zurückgerollt hat
+    uint64_t rolledBack() const { return rolledBack_.load(std::memory_order_relaxed); }
+
+    // Route aus ParsedResult (einzelnes Ereignis)
+    void handleParsed(const ParsedResult& r) { applyBatch(&r, 1); }
+
+    // Import historischer Enden (--import) in einer einzigen Transaktion mit großen
+    // mehrzeiligen INSERTs, nach Zeitstempel sortiert. Jede Zeile, die es mit gleichem ts,
+    // callsign, mode und slot schon gibt (uniq_event), wird einzeln übersprungen – so landet ein
+    // wiederholter Import oder das, was der laufende Dienst schon geschrieben hat, nicht doppelt,
+    // Lücken dazwischen werden aber gefüllt.
+    // Rückgabe: Anzahl eingefügter Zeilen, -1 bei Fehler; skipped zählt die übersprungenen.
+    long importLastHeard(const std::vector<ParsedResult>& rows, size_t& skipped);
+
+private:
+    DbConn db_;
+    MYSQL* conn = nullptr;    // aktuelle Verbindung, nur zwischen onConnect und onClose gültig
+    std::atomic<uint64_t> rolledBack_{0};
+
+    static DbConn::Settings dbSettings(std::string socket);
+
+    // Parameter je Statement in SQL-Reihenfolge; Längen wie die Spalten
+    // Zeitpunkte als Unix-Sekunden → FROM_UNIXTIME(?), also wie NOW() in der Zeitzone der Session
+    // (status/reflector ganze Sekunden, lastheard mit Millisekunden)
+    using StatusStmt    = PreparedStmt<StrParam<20>, StrParam<20>, IntParam, IntParam, StrParam<3>,
+                                       BoolParam, DoubleParam, DoubleParam, DoubleParam>;
+    using LastHeardStmt = PreparedStmt<StrParam<20>, StrParam<20>, IntParam, IntParam, StrParam<3>,
+                                       DoubleParam, DoubleParam, DoubleParam>;
+    using ReflectorStmt = PreparedStmt<StrParam<64>, DoubleParam>;
+
+    StatusStmt    st_upsert_status;
+    ReflectorStmt st_upsert_reflector_dstar, st_upsert_reflector_fusion, st_upsert_reflector_dmr;
+
+    // lastheard-INSERTs mit 1..kLastHeardRows Zeilen, bei Bedarf vorbereitet
+    static constexpr size_t kLastHeardRows = 32;
+    std::unique_ptr<LastHeardStmt> st_insert_lastheard_rows[kLastHeardRows];
+    std::vector<ParsedResult> lastHeardRows_;
+
+    // Import: deutlich größere Statements, damit zwei Wochen Logs nur wenige Round-Trips kosten
+    static constexpr size_t kImportRows = 512;
+    LastHeardStmt st_import_lastheard;
+
+    LastHeardStmt* lastHeardStmt(size_t rows);
+    bool prepareLastHeard(LastHeardStmt& st, size_t rows);
+    static void setLastHeardRow(LastHeardStmt& st, size_t i, const ParsedResult& r);
+
+    // source ist NULL, wenn unbekannt
+    static std::optional<std::string_view> sourceOrNull(Source s);
+
+    // Läuft nach jedem (Wieder-)Verbinden durch DbConn: Schema sicherstellen, Statements vorbereiten
+    bool connect(MYSQL* c);
+    void ensureEventKey();
+    void prepare_statements();
+    void destroy_statements();
+};
+
+// ---- Entkopplung Log-Lesen / DB-Schreiben ----
+// Ringpuffer fester Größe für genau einen Erzeuger (Log-Thread) und einen Verbraucher
+// (DB-Thread). head_ schreibt nur der Verbraucher, tail_ nur der Erzeuger; kein Lock.
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "SpscQueue: N muss eine Zweierpotenz sein");
+public:
+    bool tryPush(const T& v) {
+        const size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - head_.load(std::memory_order_acquire) == N) return false; // voll
+        items_[t & (N - 1)] = v;
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        const size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tail_.load(std::memory_order_acquire)) return false; // leer
+        out = items_[h & (N - 1)];
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) T items_[N];
+};
+
+// ---- Spool für Ereignisse, solange die DB nicht erreichbar ist ----
+// Datei fester Größe, per mmap eingeblendet: eine Kopfseite (Magic, head, tail) und dahinter
+// Datensätze [u32 Länge][u32 CRC32][Ereignis]. Angehängt wird nur bei tail, abgearbeitet ab head;
+// ist der Spool leer, beginnen beide wieder bei 0. Je angehängtem Stapel wird einmal
+// synchronisiert (erst die Daten, dann der Kopf) – nach einem Absturz zeigt tail nie auf
+// halb geschriebene Datensätze. Nur aus dem Writer-Thread benutzen, depth() und bytesUsed() von überall.
+// Die Größe legt open() fest; eine vorhandene Datei mit anderer Größe wird nur umgestellt, wenn sie leer ist.
+class EventSpool {
+public:
+    static constexpr size_t kDefaultBytes = 16u << 20; // ~250.000 Ereignisse (rund 60 Byte je Datensatz)
+
+    EventSpool() = default;
+    ~EventSpool();
+    EventSpool(const EventSpool&) = delete;
+    EventSpool& operator=(const EventSpool&) = delete;
+
+    bool open(const std::string& path, size_t bytes = kDefaultBytes);
+
+    bool ok() const { return map_ != nullptr; }
+    bool empty() const { return depth_.load(std::memory_order_relaxed) == 0; }
+
+    // Stapel anhängen und synchronisieren. Passt nicht alles, werden die neuesten verworfen;
+    // Rückgabe: Anzahl gespeicherter Ereignisse.
+    size_t append(const ParsedResult* ev, size_t n);
+
+    // Bis zu max Ereignisse ab head lesen (ohne zu entfernen), danach consume()
+    size_t peek(std::vector<ParsedResult>& out, size_t max);
+
+    // Die zuletzt mit peek() gelesenen Ereignisse sind in der DB
+    void consume(size_t n);
+
+    uint64_t depth() const { return depth_.load(std::memory_order_relaxed); }
+    uint64_t bytesUsed() const { return used_.load(std::memory_order_relaxed); }
+    uint64_t capacity() const { return cap_; }
+
+private:
+    struct Header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t head;   // erster noch nicht geschriebener Datensatz (Offset im Datenbereich)
+        uint64_t tail;   // Ende des letzten vollständig synchronisierten Datensatzes
+    };
+    static constexpr char kMagic[8] = {'M', 'M', 'D', 'V', 'S', 'P', 'L', '1'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 4096;  // eigene Seite, damit msync() nur den Kopf schreibt
+    static constexpr size_t kFrameBytes = 8;      // Länge + CRC32
+    static constexpr size_t kMaxRecord = 128;
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t size_ = 0;
+    Header* hdr_ = nullptr;
+    uint8_t* data_ = nullptr;
+    uint64_t cap_ = 0;
+    uint64_t peekEnd_ = 0;
+    std::atomic<uint64_t> depth_{0};
+    std::atomic<uint64_t> used_{0};   // tail - head, bei jedem syncHeader() nachgeführt
+    uint8_t buf_[kMaxRecord];
+
+    bool map(const std::string& path, size_t size);
+    void reset();
+    bool fail();
+    bool compact(uint64_t& pos, size_t need);
+    void syncRange(uint64_t from, uint64_t to);
+    void syncHeader();
+    size_t encode(const ParsedResult& r);
+    bool decodeAt(uint64_t& pos, ParsedResult& r) const;
+};
+
+// Eigener Thread für alle SQL-Zugriffe. tryPost()/post() blockieren nie: ist die Queue voll (DB
+// hängt oder startet neu), bleibt das Ereignis bei tryPost() beim Aufrufer, post() verwirft und
+// zählt es. Der Thread schläft auf einem eventfd und wird per flush() (oder bei halb voller Queue)
+// geweckt, wenn er tatsächlich wartet.
+// Mit Spool: ist die DB nicht erreichbar, landen die Stapel dort und werden nach dem Wiederverbinden
+// in der ursprünglichen Reihenfolge nachgetragen; bis dahin gehen auch neue Stapel in den Spool.
+class DbWriter {
+public:
+    explicit DbWriter(Database& db, EventSpool* spool = nullptr);
+    ~DbWriter();
+
+    DbWriter(const DbWriter&) = delete;
+    DbWriter& operator=(const DbWriter&) = delete;
+
+    // Nur vom Log-Thread aufrufen (ein Erzeuger). false: Queue voll, nichts übernommen; der
+    // Aufrufer hält das Ereignis und versucht es später erneut (Merger, Replay).
+    bool tryPost(const ParsedResult& r);
+
+    // Wie tryPost(), verwirft das Ereignis bei voller Queue aber endgültig und zählt es in drops()
+    bool post(const ParsedResult& r);
+
+    // Ende eines Lese-Ticks: alles bisher Gepostete als eine Transaktion schreiben lassen
+    void flush() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false)) wake();
+    }
+
+    // Lesepositionen, bis zu denen alle Ereignisse gepostet sind. Der Writer speichert sie
+    // erst, nachdem alles bis dahin Gepostete committet ist (danach flush() aufrufen).
+    // Ist seit dem vorigen Checkpoint ein Ereignis nicht in die DB gelangt (verworfen,
+    // zurückgerollt, Spool voll oder keiner), bleibt die gespeicherte Position davor stehen:
+    // ein Neustart liest ab dort erneut. Kommen keine Verluste mehr dazu, wird wieder
+    // gespeichert, sonst läse jeder spätere Neustart alles seit dem ersten Verlust.
+    void checkpoint(const std::map<std::string, OffsetEntry>& offsets);
+
+    // Wird im Writer-Thread nach jedem Stapel mit der Zahl aller bisher geschriebenen
+    // Ereignisse aufgerufen (Latenzmessung beim Replay). Vor dem ersten post() setzen.
+    void setCommitHook(std::function<void(uint64_t)> hook) { commitHook_ = std::move(hook); }
+
+    // ---- Zähler ----
+    size_t   depth()     const { return queue_.size(); }
+    size_t   highWater() const { return highWater_.load(std::memory_order_relaxed); }
+    uint64_t drops()     const { return drops_.load(std::memory_order_relaxed); }
+    uint64_t written()   const { return written_.load(std::memory_order_relaxed); }
+    uint64_t batches()   const { return batches_.load(std::memory_order_relaxed); }
+    uint64_t spoolDepth() const { return spool_ ? spool_->depth() : 0; }
+    uint64_t lost()      const { return lost_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kStatsIntervalMs = 60000;
+    static constexpr int kSpoolRetryMs = 5000;  // Abstand der Verbindungsversuche bei gefülltem Spool
+    static constexpr size_t kMaxBatch = 1024; // Obergrenze je Transaktion
+
+    Database& db_;
+    EventSpool* spool_;
+    SpscQueue<ParsedResult, 4096> queue_;
+    std::thread thread_;
+    int efd_ = -1;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> sleeping_{false};
+    std::atomic<size_t> highWater_{0};
+    std::atomic<uint64_t> drops_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> lost_{0};       // weder in die DB noch in den Spool gelangt
+    uint64_t spooled_ = 0, drained_ = 0;  // nur Writer-Thread
+    std::chrono::steady_clock::time_point retryAt_{};
+    std::vector<ParsedResult> drain_;
+
+    uint64_t posted_ = 0;                 // nur Log-Thread
+    uint64_t consumed_ = 0;               // nur Writer-Thread
+    std::mutex cpMtx_;
+    std::map<std::string, OffsetEntry> cpOffsets_;
+    uint64_t cpSeq_ = 0;
+    std::atomic<bool> cpPending_{false};
+    uint64_t cpMissing_ = 0;              // missing() beim zuletzt zurückgehaltenen Checkpoint, nur Writer-Thread
+    bool cpHeld_ = false;                 // nur Writer-Thread
+    std::function<void(uint64_t)> commitHook_;
+
+    // Ereignisse, die weder in der DB noch im Spool stehen
+    uint64_t missing() const { return drops() + lost() + db_.rolledBack(); }
+
+    void maybeCheckpoint();
+    void store(const std::vector<ParsedResult>& batch);
+    void drainSpool();
+    void wake();
+    void run();
+};
+
+// ---- Zusammenführen der Logdateien nach Zeitstempel ----
+// Jede Logdatei liefert ihre Ereignisse bereits in zeitlicher Folge. Der Merger hält sie je
+// Datei zurück und gibt immer das älteste aus (k-Wege-Merge). Ein Ereignis wird spätestens
+// nach window freigegeben, auch wenn eine andere Datei (noch) nichts geliefert hat.
+class EventMerger {
+public:
+    explicit EventMerger(std::chrono::milliseconds window) : window_(window) {}
+
+    // Anzahl der Logdateien; auch eine (noch) stumme Datei hält die anderen zurück
+    void setStreamCount(size_t n) {
+        if (n > streams_.size()) { streams_.resize(n); closed_.resize(n, 0); }
+    }
+
+    void push(StreamId stream, const ParsedResult& r);
+
+    // Die Datei liefert nichts mehr: zurückgehaltene Ereignisse gehen noch hinaus, leer hält
+    // der Stream die anderen nicht mehr auf. Ein späteres push() öffnet ihn wieder.
+    void closeStream(StreamId stream) {
+        if (stream < closed_.size()) closed_[stream] = 1;
+    }
+
+    // Gibt alle Ereignisse frei, deren Reihenfolge feststeht oder deren Wartezeit um ist.
+    // Liefert emit false (Ziel voll), bleibt das Ereignis zurückgehalten und drain() endet mit false.
+    template <typename F>
+    bool drain(F&& emit) {
+        const auto now = std::chrono::steady_clock::now();
+        while (held_ > 0) {
+            Queue* oldest = nullptr;
+            bool otherEmpty = false;
+            for (size_t i = 0; i < streams_.size(); ++i) {
+                auto& q = streams_[i];
+                if (q.empty()) { if (!closed_[i]) otherEmpty = true; continue; }
+                if (!oldest || q.front().ev.ts < oldest->front().ev.ts) oldest = &q;
+            }
+            // Eine leere Datei könnte noch Älteres liefern → bis zum Ablauf des Fensters warten
+            if (otherEmpty && oldest->front().arrived + window_ > now) break;
+            if (!emit(oldest->front().ev)) return false;
+            oldest->pop_front();
+            --held_;
+        }
+        return true;
+    }
+
+    bool empty() const { return held_ == 0; }
+
+    // Millisekunden bis zur nächsten Freigabe, -1 wenn nichts zurückgehalten wird
+    int msUntilDue() const;
+
+private:
+    struct Held {
+        ParsedResult ev;
+        std::chrono::steady_clock::time_point arrived;
+    };
+    // FIFO je Datei auf einem vector statt std::deque: die Kapazität bleibt erhalten,
+    // im eingeschwungenen Zustand allokiert push() nicht mehr
+    struct Queue {
+        std::vector<Held> items;
+        size_t head = 0;
+
+        bool empty() const { return head == items.size(); }
+        const Held& front() const { return items[head]; }
+        void push_back(const Held& h) {
+            if (head > 0 && items.size() == items.capacity()) {   // vorn Platz schaffen statt wachsen
+                items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(head));
+                head = 0;
+            }
+            items.push_back(h);
+        }
+        void pop_front() {
+            if (++head == items.size()) { items.clear(); head = 0; }
+        }
+    };
+    std::chrono::milliseconds window_;
+    std::vector<Queue> streams_;
+    std::vector<char> closed_;
+    size_t held_ = 0;
+};
+
+// ---- Dateibeobachtung (inotify + epoll) ----
+// Beobachtet die Verzeichnisse der Logdateien, damit auch die Dateien des nächsten
+// Tages (IN_CREATE) und neu angelegte Dateien nach logrotate erkannt werden.
+// wait() schläft ohne Timeout, bis eine relevante Datei geschrieben oder angelegt wurde.
+class LogWatcher {
+public:
+    LogWatcher();
+    ~LogWatcher();
+
+    LogWatcher(const LogWatcher&) = delete;
+    LogWatcher& operator=(const LogWatcher&) = delete;
+
+    bool ok() const { return ifd_ >= 0 && epfd_ >= 0; }
+
+    // inotify-Deskriptor für eine fremde EventLoop (dann dort lesbar → drain() statt wait())
+    int fd() const { return ifd_; }
+
+    // Beobachtet die Verzeichnisse der Pfade (idempotent). Liefert false, wenn ein
+    // Verzeichnis (noch) nicht beobachtet werden kann – dann muss gepollt werden.
+    bool watch(const std::vector<std::string>& paths);
+
+    // Blockiert bis zu timeoutMs (-1 = unbegrenzt). true, wenn eine relevante Datei
+    // geändert oder angelegt wurde (oder die Queue übergelaufen ist).
+    bool wait(int timeoutMs);
+
+    // Anstehende Ereignisse lesen; true, wenn eine relevante Datei dabei war
+    bool drain();
+
+private:
+    int ifd_ = -1;
+    int epfd_ = -1;
+    std::map<std::string, int> dirs_;       // Verzeichnis -> watch descriptor
+    std::map<int, std::string> wdDirs_;     // watch descriptor -> Verzeichnis
+    std::set<std::string> names_;           // beobachtete Dateinamen
+};
+
+// ---- Lesen der Logdateien ----
+// Hält den Dateideskriptor über die Ticks offen und liest mit pread in einen
+// wiederverwendeten Puffer (mind. 64 KiB). Zeilen werden mit memchr getrennt (in glibc
+// per SSE2/AVX2 bzw. NEON vektorisiert) und als string_view in den Puffer übergeben.
+// Eine unvollständige letzte Zeile bleibt im Puffer und wird beim nächsten Aufruf
+// ergänzt, ohne sie erneut von der Karte zu lesen.
+class LogReader {
+public:
+    explicit LogReader(std::string path) : path_(std::move(path)), buf_(kMinBuf) {}
+    ~LogReader() { closeFd(); }
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    // Dateigröße beim letzten readFrom()
+    uint64_t sizeAtLastRead() const { return lastSize_; }
+
+    // true, wenn vor offset nicht mehr die zuletzt gelesenen Bytes stehen: die Datei wurde
+    // abgeschnitten (copytruncate) und ist seitdem schon wieder über offset hinaus gewachsen.
+    // Ohne Vergleichswerte (anderer Offset, Datei neu geöffnet) false.
+    bool replacedBefore(uint64_t offset);
+
+    // Liest ab startOffset bis EOF und ruft onLine für jede vollständige Zeile (ohne \r\n).
+    // Rückgabe: Offset hinter der letzten vollständigen Zeile.
+    template <typename F>
+    uint64_t readFrom(uint64_t startOffset, F&& onLine) {
+        if (!ensureOpen()) return startOffset;
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) { closeFd(); return startOffset; }
+        const uint64_t size = static_cast<uint64_t>(st.st_size);
+        lastSize_ = size;
+
+        // falls größer als aktuelle Größe (abgeschnitten), fangen wir bei 0 an
+        if (startOffset > size) startOffset = 0;
+
+        // Übertrag vom letzten Mal nur verwenden, wenn er genau hier anschließt
+        if (carryOffset_ != startOffset) carryLen_ = 0;
+        uint64_t lineStart = startOffset;              // Dateioffset von buf_[0]
+        uint64_t readPos   = startOffset + carryLen_;  // nächstes zu lesendes Byte
+
+        while (readPos < size) {
+            if (carryLen_ == buf_.size()) buf_.resize(buf_.size() * 2); // Zeile länger als Puffer
+            const size_t want = std::min<uint64_t>(buf_.size() - carryLen_, size - readPos);
+            ssize_t n = ::pread(fd_, buf_.data() + carryLen_, want, static_cast<off_t>(readPos));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            readPos += static_cast<uint64_t>(n);
+
+            const char* base = buf_.data();
+            const char* end  = base + carryLen_ + static_cast<size_t>(n);
+            const char* p    = base;
+            while (p < end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                if (!nl) break;
+                std::string_view line(p, static_cast<size_t>(nl - p));
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1); // CRLF
+                onLine(line);
+                p = nl + 1;
+            }
+
+            // Rest (unvollständige Zeile) an den Pufferanfang schieben
+            const size_t consumed = static_cast<size_t>(p - base);
+            carryLen_ = static_cast<size_t>(end - p);
+            if (consumed > 0 && carryLen_ > 0) std::memmove(buf_.data(), p, carryLen_);
+            lineStart += consumed;
+        }
+
+        carryOffset_ = lineStart;
+        if (lineStart != sigOffset_) rememberTail(lineStart);
+        // Puffer nach einer sehr langen Zeile wieder verkleinern
+        if (carryLen_ == 0 && buf_.size() > kMinBuf) { buf_.resize(kMinBuf); buf_.shrink_to_fit(); }
+        return lineStart;
+    }
+
+private:
+    static constexpr size_t kMinBuf = 64 * 1024;
+    static constexpr size_t kSigBytes = 256;   // reicht für eine ganze Logzeile mit Zeitstempel
+
+    std::string path_;
+    int fd_ = -1;
+    uint64_t inode_ = 0;
+    std::vector<char> buf_;
+    size_t carryLen_ = 0;        // Bytes einer unvollständigen Zeile am Pufferanfang
+    uint64_t carryOffset_ = 0;   // Dateioffset dieser Bytes
+    uint64_t lastSize_ = 0;
+    char sig_[kSigBytes];        // die Bytes vor sigOffset_ (Ende der zuletzt gelesenen Zeilen)
+    size_t sigLen_ = 0;
+    uint64_t sigOffset_ = 0;
+
+    void closeFd();
+    void rememberTail(uint64_t offset);
+
+    // Öffnet die Datei (neu), wenn sie noch nicht offen ist oder unter dem Pfad
+    // inzwischen eine andere Datei liegt (logrotate, neuer Tag).
+    bool ensureOpen();
+};
+
+// Liest ab startOffset alle vollständigen Zeilen, Erkanntes (zuerst erzwungene Enden) geht
+// je Stream an den Merger. pending ist ein Puffer des Aufrufers, der über die Aufrufe
+// erhalten bleibt. Rückgabe: Offset hinter der letzten vollständigen Zeile.
+uint64_t processFileFromOffset(LogReader& reader, LogParser& parser, EventMerger& merger,
+                               uint64_t startOffset, StreamId stream, std::vector<ParsedResult>& pending);
+
+// ---- Live-Betrieb (tail -F) ----
+// Optionen des Live-Betriebs; dieselben versteht DVconfig hinter --with-status
+struct StatusOptions {
+    std::vector<std::string> paths;     // leer = heutige Standardpfade
+    int reorderMs = 250;
+    size_t spoolBytes = EventSpool::kDefaultBytes;
+    std::string importDir, replayFile;
+    double speed = 1.0;
+    std::string error;                  // nicht leer: unbekannte oder unvollständige Option
+};
+
+//   --reorder-ms <ms>  max. Verzögerung für die zeitliche Sortierung über die Logdateien (Default 250)
+//   --import <dir>     alle (auch rotierten/.gz) Logs im Verzeichnis einmalig in lastheard laden, dann beenden
+//   --replay <file>    Logdatei einmal durch Parser und DB-Writer schicken, Zusammenfassung ausgeben
+//   --speed <N>x       Tempo beim Replay relativ zu den Zeitstempeln (Default 1x, "max" = ohne Pause)
+//   --spool-mb <N>     Größe des Spools für Ausfälle der DB (Default 16, 0 = kein Spool)
+//   alles andere       Logdatei oder Verzeichnis (→ die drei Logs des Tages)
+// Ein unbekanntes "--..." ist kein Logpfad, sondern ein Fehler (opt.error).
+StatusOptions parseStatusOptions(int argc, char** argv, int first = 1);
+
+// Fehler und die Liste der Optionen nach stderr
+void printStatusUsage(const char* prog, const std::string& error);
+
+// Ein tick() liest alle Logdateien ab der gemerkten Position, gibt die Ereignisse an den
+// DbWriter und übergibt die Lesepositionen. Wann der nächste tick() fällig ist, entscheidet
+// der Aufrufer: die Schleife in main() oder die EventLoop von DVconfig (inotify-fd + Timer).
+class StatusTail {
+public:
+    StatusTail(const LocalConfig& cfg, Database& database, const StatusOptions& opt);
+
+    StatusTail(const StatusTail&) = delete;
+    StatusTail& operator=(const StatusTail&) = delete;
+
+    // Beobachtet die Verzeichnisse der Logdateien; fd() für eine fremde EventLoop
+    LogWatcher& watcher() { return watcher_; }
+
+    // Rückgabe: spätestens nach so vielen ms erneut aufrufen, -1 = erst nach einer Dateiänderung
+    int tick();
+
+private:
+    // Dateien des Vortags, die nach dem Datumswechsel noch leergelesen werden
+    struct Draining {
+        StreamId stream;
+        uint64_t size;
+        std::chrono::steady_clock::time_point changed;   // letzte Größenänderung
+    };
+    static constexpr auto kQuiescent = std::chrono::minutes(10);
+    static constexpr int kBackpressureMs = 50;   // erneuter Versuch bei voller Writer-Queue
+
+    const std::vector<std::string> argPaths_;
+    LogParser parser_;              // bleibt über die gesamte Laufzeit bestehen
+    std::vector<ParsedResult> pending_;   // erzwungene Enden je Zeile, Kapazität bleibt erhalten
+    EventSpool spool_;              // Ereignisse, die bei DB-Ausfall aufgelaufen sind, überdauern auch einen Neustart
+    DbWriter db_;
+    EventMerger merger_;            // Ereignisse aller Logdateien in Zeitstempel-Reihenfolge an die DB
+    std::map<std::string, OffsetEntry> offsets_;
+    std::map<std::string, OffsetEntry> checkpointed_; // zuletzt an den Writer übergebener Stand
+    bool didBackfill_ = false;
+    LogWatcher watcher_;            // wartet auf Schreibzugriffe statt im Sekundentakt zu pollen
+    std::map<std::string, LogReader> readers_;  // fd und Puffer bleiben über die Ticks erhalten
+    std::map<std::string, Draining> draining_;
+    std::vector<std::string> prevPaths_;
+
+    // Zähler für logrotate
+    struct {
+        uint64_t truncations = 0;      // copytruncate
+        uint64_t rotations = 0;        // umbenannt und neu angelegt
+        uint64_t recoveredBytes = 0;   // danach aus "<log>.1" nachgelesen
+        uint64_t lostBytes = 0;        // hinter der gespeicherten Position, aber nicht mehr lesbar
+    } tail_;
+    uint64_t tailReported_ = 0;
+
+    static EventSpool* openSpool(EventSpool& spool, size_t bytes);
+
+    // Liest eine Datei ab der gemerkten Position; stream = Rolle (DMRGateway/MMDVM/YSFGateway)
+    std::optional<uint64_t> tailOne(const std::string& p, StreamId stream);
+
+    // Nach logrotate den Rest ab from aus der Kopie lesen (usable: sie enthält den alten Inhalt);
+    // sonst zählen die ungelesenen Bytes (unread) als verloren.
+    void readRotated(const std::string& p, const std::string& copy, bool usable, uint64_t from,
+                     uint64_t unread, StreamId stream, const char* what);
+};
+
+// ---- Einmalige Läufe ----
+// --import <dir>: lastheard aus allen (auch rotierten und komprimierten) Logs aufbauen
+int runImport(const std::string& dir, const LocalConfig& cfg, Database& database);
+
+// --replay <file>: Logdatei durch Parser, Merger und DbWriter schicken und Durchsatz/Latenz melden
+int runReplay(const std::string& path, double speed, const LocalConfig& cfg,
+              Database& database, std::chrono::milliseconds window);
+
+} // namespace status
@@ -0,0 +1,168 @@
+/*
+alloctest.cpp
+=============
+
+Zählt die Heap-Allokationen von LogParser::processLine (samt takePending) je
+Zeile. Der erste Durchlauf über den Korpus wärmt auf: Rufzeichen landen in der
+Tabelle, pending_ und der Ergebnisvektor wachsen auf ihre Größe. Im zweiten
+Durchlauf über dieselben Zeilen darf keine einzige Allokation mehr vorkommen.
+
+Die Dateien laufen wie im Dienst mit eigener StreamId durch einen Parser, mit
+eigenem Rufzeichen und Duplex, damit auch die Eigen-Echo-Prüfung dabei ist.
+
+Danach derselbe Lesepfad wie StatusTail::tailOne: die Zeilen werden in Stücken
+an temporäre Logdateien angehängt und mit LogReader/processFileFromOffset in
+einen EventMerger gelesen, der sofort freigibt. Gezählt wird nur das Lesen und
+Freigeben, nicht das Schreiben der Testdateien; auch hier muss der zweite
+Durchlauf ohne Allokation auskommen.
+
+Aufruf: mmdvm-alloctest <Logdatei ...>
+  Exit-Code 1, wenn im zweiten Durchlauf allokiert wurde. "make test" erzeugt
+  den Korpus mit mmdvm-loggen.
+*/
+
+#include "../StatusPipeline.h"
+
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace status;
+
+// ---- Allokationen zählen ----
+static std::atomic<uint64_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+static bool readLines(const char* path, std::vector<std::string>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        out.push_back(line);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Aufruf: %s <Logdatei ...>\n", argv[0]);
+        return 2;
+    }
+    std::vector<std::vector<std::string>> files(argc - 1);
+    for (int i = 1; i < argc; ++i) {
+        if (!readLines(argv[i], files[i - 1])) {
+            std::fprintf(stderr, "kann %s nicht lesen\n", argv[i]);
+            return 2;
+        }
+    }
+
+    LocalConfig lc;
+    lc.callsign = "DL1ABC";
+    lc.duplex = 1;
+    LogParser parser(lc);
+    std::vector<ParsedResult> pending;
+
+    uint64_t lines = 0, events = 0, worstLine = 0;
+    std::string_view worst;
+    auto pass = [&](bool measure) {
+        for (size_t f = 0; f < files.size(); ++f) {
+            for (const auto& line : files[f]) {
+                const uint64_t before = g_allocs.load(std::memory_order_relaxed);
+                auto res = parser.processLine(line, static_cast<StreamId>(f));
+                parser.takePending(pending);
+                const uint64_t n = g_allocs.load(std::memory_order_relaxed) - before;
+                if (!measure) continue;
+                ++lines;
+                events += pending.size() + (res ? 1 : 0);
+                if (n > worstLine) { worstLine = n; worst = line; }
+            }
+        }
+    };
+
+    pass(false);
+    const uint64_t start = g_allocs.load(std::memory_order_relaxed);
+    pass(true);
+    const uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - start;
+
+    std::printf("processLine: %llu Zeilen, %llu Ereignisse, %llu Allokationen (%.4f je Zeile)\n",
+                (unsigned long long)lines, (unsigned long long)events, (unsigned long long)allocs,
+                lines ? static_cast<double>(allocs) / lines : 0.0);
+    bool ok = allocs == 0 && events > 0;
+    if (allocs) {
+        std::printf("meiste Allokationen (%llu) bei: %.*s\n", (unsigned long long)worstLine,
+                    static_cast<int>(worst.size()), worst.data());
+    }
+    if (events == 0) std::printf("Korpus ohne ein einziges Ereignis\n");
+
+    // ---- Lesepfad wie tailOne ----
+    char dir[] = "/tmp/mmdvm-alloctest-XXXXXX";
+    if (!::mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    std::vector<std::string> paths;
+    std::vector<int> fds;
+    for (size_t f = 0; f < files.size(); ++f) {
+        paths.push_back(std::string(dir) + "/log" + std::to_string(f) + ".log");
+        fds.push_back(::open(paths.back().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644));
+        if (fds.back() < 0) { std::perror(paths.back().c_str()); return 2; }
+    }
+    std::vector<LogReader> readers(paths.begin(), paths.end());
+    std::vector<uint64_t> offsets(files.size(), 0);
+    LogParser tailParser(lc);
+    EventMerger merger(std::chrono::milliseconds(0));
+    merger.setStreamCount(files.size());
+    std::cout.setstate(std::ios::badbit);   // printResult schreibt sonst jedes Ereignis
+
+    constexpr size_t kChunk = 64;   // Zeilen je "Tick" und Datei
+    uint64_t tailEvents = 0, tailAllocs = 0;
+    auto tailPass = [&](bool measure) {
+        for (size_t at = 0; ; at += kChunk) {
+            bool any = false;
+            for (size_t f = 0; f < files.size(); ++f) {
+                const size_t end = std::min(at + kChunk, files[f].size());
+                for (size_t i = at; i < end; ++i) {
+                    const std::string& l = files[f][i];
+                    if (::write(fds[f], l.data(), l.size()) < 0 || ::write(fds[f], "\n", 1) < 0) std::abort();
+                    any = true;
+                }
+            }
+            if (!any) break;
+            const uint64_t before = g_allocs.load(std::memory_order_relaxed);
+            for (size_t f = 0; f < files.size(); ++f)
+                offsets[f] = processFileFromOffset(readers[f], tailParser, merger, offsets[f],
+                                                   static_cast<StreamId>(f), pending);
+            merger.drain([&](const ParsedResult&) { if (measure) ++tailEvents; return true; });
+            if (measure) tailAllocs += g_allocs.load(std::memory_order_relaxed) - before;
+        }
+    };
+    tailPass(false);
+    tailPass(true);
+    std::cout.clear();
+
+    for (size_t f = 0; f < files.size(); ++f) { ::close(fds[f]); ::unlink(paths[f].c_str()); }
+    ::rmdir(dir);
+
+    std::printf("Lesepfad:    %llu Ereignisse, %llu Allokationen\n",
+                (unsigned long long)tailEvents, (unsigned long long)tailAllocs);
+    if (tailAllocs || tailEvents == 0) ok = false;
+    return ok ? 0 : 1;
+}
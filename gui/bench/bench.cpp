@@ -0,0 +1,318 @@
+/*
+bench.cpp
+=========
+
+Micro-Benchmarks für die heißen Pfade von mmdvm-status und DVconfig:
+LogParser::processLine (relevante und irrelevante Zeilen je Betriebsart),
+Zeitstempel, Rufzeichen-Prüfung, JSON-Auswertung des MQTT-Listeners und
+renderConfigFile::setValue. Gemessen werden ns/op und Allokationen/op.
+
+Aufruf: mmdvm-bench [Optionen]
+  --filter <text>       nur Fälle, deren Name <text> enthält
+  --min-time <ms>       Messzeit je Fall (Default 500; auf dem Pi ruhig mehr)
+  --save <datei>        Ergebnisse als Baseline speichern
+  --compare <datei>     mit einer Baseline vergleichen; Exit-Code 1 bei Regression
+  --threshold <proz>    ab wie viel Prozent langsamer eine Regression gemeldet wird (Default 10)
+
+Typisch: einmal "make baseline" auf dem Zielsystem, nach Änderungen "make compare".
+*/
+
+#include "../StatusPipeline.h"
+
+#include "../parser/MqttListener.h"
+#include "../parser/renderConfigFile.h"
+
+#include <new>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <sys/utsname.h>
+
+using namespace status;
+
+// ---- Allokationen zählen ----
+static std::atomic<uint64_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// Ergebnis für den Optimierer sichtbar machen (GCC/Clang, x86 und ARM)
+template <typename T>
+static inline void keep(T&& v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+// ---- Messung ----
+struct Case {
+    std::string name;
+    std::function<void(uint64_t iters)> run;
+};
+
+struct Result {
+    std::string name;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+};
+
+// Iterationszahl so wählen, dass ein Durchlauf etwa minTime/kRuns dauert; dann kRuns
+// Durchläufe und den schnellsten nehmen: Störungen durch andere Prozesse machen nur
+// langsamer, so bleibt der Vergleich auch auf einem belasteten Pi stabil.
+static Result measure(const Case& c, std::chrono::milliseconds minTime) {
+    using clock = std::chrono::steady_clock;
+    constexpr int kRuns = 5;
+    const auto target = minTime / kRuns;
+
+    uint64_t iters = 1;
+    for (;;) {
+        const auto t0 = clock::now();
+        c.run(iters);
+        const auto dt = clock::now() - t0;
+        if (dt >= target / 4 || iters >= (1ull << 40)) {
+            const double per = std::chrono::duration<double>(dt).count() / static_cast<double>(iters);
+            iters = std::max<uint64_t>(1, static_cast<uint64_t>(std::chrono::duration<double>(target).count() / std::max(per, 1e-12)));
+            break;
+        }
+        iters *= 4;
+    }
+
+    std::vector<double> ns;
+    uint64_t allocs = 0;
+    for (int r = 0; r < kRuns; ++r) {
+        const uint64_t a0 = g_allocs.load(std::memory_order_relaxed);
+        const auto t0 = clock::now();
+        c.run(iters);
+        const auto dt = clock::now() - t0;
+        allocs = g_allocs.load(std::memory_order_relaxed) - a0;
+        ns.push_back(std::chrono::duration<double, std::nano>(dt).count() / static_cast<double>(iters));
+    }
+    return Result{c.name, *std::min_element(ns.begin(), ns.end()), static_cast<double>(allocs) / static_cast<double>(iters)};
+}
+
+// ---- Baseline ----
+// Format: eine Zeile je Fall "<name> <ns/op> <allocs/op>", Kommentare mit '#'
+static std::map<std::string, Result> loadBaseline(const std::string& path) {
+    std::map<std::string, Result> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream is(line);
+        Result r;
+        if (is >> r.name >> r.nsPerOp >> r.allocsPerOp) out[r.name] = r;
+    }
+    return out;
+}
+
+static std::string machine() {
+    utsname u{};
+    return uname(&u) == 0 ? u.machine : "unknown";
+}
+
+static bool saveBaseline(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "# mmdvm-bench baseline, " << machine() << "\n";
+    for (const auto& r : results)
+        out << r.name << " " << fmtNum(r.nsPerOp) << " " << fmtNum(r.allocsPerOp) << "\n";
+    return out.good();
+}
+
+// ---- Testdaten ----
+// Ein Lauf wechselt zyklisch durch die Zeilen; Start und Ende kommen paarweise, damit
+// der Parser keine erzwungenen Enden erzeugt.
+static Case processLineCase(std::string name, std::vector<std::string> lines) {
+    auto parser = std::make_shared<LogParser>();
+    auto data = std::make_shared<std::vector<std::string>>(std::move(lines));
+    return Case{"processLine/" + name, [parser, data](uint64_t iters) {
+        std::vector<ParsedResult> pending;
+        const size_t n = data->size();
+        for (uint64_t i = 0; i < iters; ++i) {
+            auto res = parser->processLine((*data)[i % n]);
+            parser->takePending(pending);
+            keep(res);
+        }
+    }};
+}
+
+// Ini-Datei in der Größe einer MMDVM.ini (Abschnitte mit je einigen Schlüsseln)
+static std::string writeSampleIni() {
+    char path[] = "/tmp/mmdvm-bench-XXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0) return {};
+    ::close(fd);
+
+    static const char* const sections[] = {"General", "Info", "Log", "CW Id", "DMR Id Lookup", "NXDN Id Lookup",
+                                           "Modem", "Transparent Data", "D-Star", "DMR", "System Fusion", "P25",
+                                           "NXDN", "FM", "D-Star Network", "DMR Network", "System Fusion Network"};
+    std::ofstream out(path, std::ios::trunc);
+    for (const char* sec : sections) {
+        out << "[" << sec << "]\n";
+        if (std::string_view(sec) == "General") out << "Callsign=DL1ABC\nId=262123401\nDuplex=0\n";
+        if (std::string_view(sec) == "Info") out << "RXFrequency=439450000\nLocation=\"myCity\"\nDescription=\"myCountry\"\n";
+        for (int k = 0; k < 15; ++k) out << "Key" << k << "=" << k * 7 << "\n";
+        out << "\n";
+    }
+    return path;
+}
+
+static std::vector<Case> makeCases() {
+    std::vector<Case> cases;
+    const std::string ts = "M: 2025-10-12 10:00:00.000 ";
+    const std::string te = "M: 2025-10-12 10:00:05.000 ";
+    const std::string td = "D: 2025-10-12 10:00:02.000 ";
+
+    cases.push_back(processLineCase("dstar_relevant", {
+        ts + "D-Star, received RF header from DL1ABC  /ID51 to CQCQCQ  ",
+        te + "D-Star, received RF end of transmission from DL1ABC  /ID51 to CQCQCQ  , 5.0 seconds, BER: 0.1%",
+        ts + "D-Star, received network header from DB0XYZ  /     to CQCQCQ   via DCS002 C",
+        te + "D-Star, received network end of transmission from DB0XYZ  /     to CQCQCQ  , 5.0 seconds, 0% packet loss, BER: 0.0%"}));
+    cases.push_back(processLineCase("dstar_irrelevant", {
+        td + "D-Star, network slow data text = \"DL1ABC  73\"",
+        td + "D-Star, Opening D-Star network connection"}));
+    cases.push_back(processLineCase("ysf_relevant", {
+        ts + "YSF, received RF header from DL1ABC     to DG-ID 0",
+        te + "YSF, received RF end of transmission from DL1ABC     to DG-ID 0, 5.0 seconds, BER: 0.2%",
+        ts + "YSF, received network data from OE3XYZ     to DG-ID 29 at FCS00490",
+        te + "YSF, received network end of transmission from OE3XYZ     to DG-ID 29, 5.0 seconds, 0% packet loss, BER: 0.0%"}));
+    cases.push_back(processLineCase("ysf_irrelevant", {
+        td + "YSF, Opening YSF network connection",
+        td + "YSF, audio frames lost"}));
+    cases.push_back(processLineCase("dmr_relevant", {
+        ts + "DMR Slot 2, received RF voice header from DL1ABC to TG 262",
+        te + "DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 5.0 seconds, BER: 0.2%",
+        ts + "DMR Slot 1, received network voice header from OE3XYZ to TG 91",
+        te + "DMR Slot 1, received network end of voice transmission from OE3XYZ to TG 91, 5.0 seconds, 0% packet loss, BER: 0.0%"}));
+    cases.push_back(processLineCase("dmr_irrelevant", {
+        td + "DMR Slot 2, audio sequence no. 74, audio frames lost",
+        td + "DMR Talker Alias (Data Format 1, Received 6/24 char): 'DL1ABC'"}));
+    cases.push_back(processLineCase("link", {
+        ts + "Linked to DE-C4FM-Germany",
+        ts + "BM_2621_Germany, Logged into the master successfully",
+        ts + "D-Star link status set to \"Verlinkt zu DCS002 C\""}));
+    cases.push_back(processLineCase("noise", {
+        td + "Debug stuff with no relevance at all, nothing here",
+        "I: 2025-10-12 10:00:02.000 Loaded 245677 Ids to the DMR callsign lookup table"}));
+
+    {
+        auto parser = std::make_shared<LogParser>();
+        const std::string line = ts + "DMR Slot 2, received RF voice header from DL1ABC to TG 262";
+        cases.push_back(Case{"extractTimestamp/same_day", [parser, line](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) { auto t = parser->timestampOf(line); keep(t); }
+        }});
+        const std::string other = "M: 2025-10-13 00:00:01.000 Mode set to Idle";
+        cases.push_back(Case{"extractTimestamp/day_change", [parser, line, other](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) { auto t = parser->timestampOf(i & 1 ? other : line); keep(t); }
+        }});
+    }
+
+    {
+        static const std::string_view calls[] = {"DL1ABC  /ID51", "  OE3XYZ  ", "2621234", "HB9ABC/P", "DB0XYZ  /    "};
+        cases.push_back(Case{"callsign/sanitize_validate", [](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) {
+                std::string_view cs = LogParser::sanitizeCallsign(calls[i % std::size(calls)]);
+                bool ok = isValidCallsign(cs);
+                keep(ok);
+            }
+        }});
+    }
+
+    {
+        const std::string payload =
+            R"({"time":"2025-10-12 10:00:00","talk":"start","call":"DL1ABC","tg":"262","server":"fm-funknetz-01"})";
+        cases.push_back(Case{"mqtt/parseTalkerEvent", [payload](uint64_t iters) {
+            MqttListener::TalkerEvent ev;
+            for (uint64_t i = 0; i < iters; ++i) { bool ok = MqttListener::parseTalkerEvent(payload, ev); keep(ok); }
+        }});
+    }
+
+    {
+        const std::string ini = writeSampleIni();
+        auto cfg = std::make_shared<renderConfigFile>(ini);
+        ::unlink(ini.c_str());
+        cases.push_back(Case{"config/setValue_unchanged", [cfg](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) { bool ch = cfg->setValue("Location", "myCity", "Info"); keep(ch); }
+        }});
+        cases.push_back(Case{"config/setValue_changed", [cfg](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) {
+                bool ch = cfg->setValue("RXFrequency", i & 1 ? "439450000" : "431850000", "Info");
+                keep(ch);
+            }
+        }});
+    }
+    return cases;
+}
+
+int main(int argc, char** argv) {
+    std::string filter, savePath, comparePath;
+    std::chrono::milliseconds minTime{500};
+    double threshold = 10;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        if (a == "--filter" && i + 1 < argc)         filter = argv[++i];
+        else if (a == "--min-time" && i + 1 < argc)  minTime = std::chrono::milliseconds(std::max(10, std::atoi(argv[++i])));
+        else if (a == "--save" && i + 1 < argc)      savePath = argv[++i];
+        else if (a == "--compare" && i + 1 < argc)   comparePath = argv[++i];
+        else if (a == "--threshold" && i + 1 < argc) threshold = std::max(0.0, std::atof(argv[++i]));
+        else { std::cerr << "unbekannte Option: " << a << "\n"; return 2; }
+    }
+
+    std::map<std::string, Result> baseline;
+    if (!comparePath.empty()) {
+        baseline = loadBaseline(comparePath);
+        if (baseline.empty()) { std::cerr << "keine Baseline in " << comparePath << "\n"; return 2; }
+    }
+
+    std::printf("# %s, min-time %lld ms\n", machine().c_str(), static_cast<long long>(minTime.count()));
+    std::printf("%-32s %12s %10s", "case", "ns/op", "allocs/op");
+    if (!baseline.empty()) std::printf(" %12s %9s", "base ns/op", "delta");
+    std::printf("\n");
+
+    std::vector<Result> results;
+    int regressions = 0;
+    for (const auto& c : makeCases()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        const Result r = measure(c, minTime);
+        results.push_back(r);
+        std::printf("%-32s %12.1f %10.2f", r.name.c_str(), r.nsPerOp, r.allocsPerOp);
+
+        if (auto it = baseline.find(r.name); it != baseline.end()) {
+            const Result& b = it->second;
+            const double delta = b.nsPerOp > 0 ? (r.nsPerOp - b.nsPerOp) / b.nsPerOp * 100.0 : 0.0;
+            const bool slower = delta > threshold;
+            // Allokationen schwanken nur durch Rundung und amortisiertes Wachstum
+            const bool moreAllocs = r.allocsPerOp > b.allocsPerOp * 1.01 + 0.05;
+            std::printf(" %12.1f %+8.1f%%", b.nsPerOp, delta);
+            if (slower || moreAllocs) {
+                std::printf("  REGRESSION%s", moreAllocs ? " (allocs)" : "");
+                ++regressions;
+            }
+        } else if (!baseline.empty()) {
+            std::printf(" %12s %9s", "-", "neu");
+        }
+        std::printf("\n");
+    }
+
+    if (!savePath.empty()) {
+        if (!saveBaseline(savePath, results)) { std::cerr << "kann " << savePath << " nicht schreiben\n"; return 2; }
+        std::printf("# Baseline gespeichert: %s\n", savePath.c_str());
+    }
+    if (!baseline.empty()) {
+        std::printf("# %d Regression(en) bei Schwelle %s%%\n", regressions, fmtNum(threshold).c_str());
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+bindtest.cpp
+============
+
+Prüft die Zeitstempel, die Database an FROM_UNIXTIME(?) bindet. status.updated_at und
+reflector.updated_at sind DATETIME ohne Nachkommastellen: ein Bruchteil ab .5 würde dort
+auf die nächste Sekunde (und um Mitternacht auf den nächsten Tag) gerundet. Erwartet werden
+ganze, abgeschnittene Sekunden; lastheard.ts (DATETIME(3)) bekommt die Millisekunden.
+
+Die Zeitpunkte kommen wie im Dienst aus Logzeilen, damit auch das Einlesen der
+Millisekunden mitgeprüft ist.
+
+Aufruf: mmdvm-bindtest
+  Exit-Code 1 bei einer Abweichung.
+*/
+
+#include "../StatusPipeline.h"
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+using namespace status;
+
+struct Case {
+    const char* line;
+    int year, month, day, hour, minute, second, ms;
+};
+
+static const Case kCases[] = {
+    {"M: 2025-10-12 12:34:59.600 DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 3.2 seconds, BER: 0.1%",
+     2025, 10, 12, 12, 34, 59, 600},
+    {"M: 2025-10-12 12:34:59.500 DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 3.2 seconds, BER: 0.1%",
+     2025, 10, 12, 12, 34, 59, 500},
+    {"M: 2025-10-12 12:34:59.499 DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 3.2 seconds, BER: 0.1%",
+     2025, 10, 12, 12, 34, 59, 499},
+    {"M: 2025-12-31 23:59:59.999 DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 3.2 seconds, BER: 0.1%",
+     2025, 12, 31, 23, 59, 59, 999},
+    {"M: 2025-10-12 00:00:00.000 DMR Slot 2, received RF end of voice transmission from DL1ABC to TG 262, 3.2 seconds, BER: 0.1%",
+     2025, 10, 12, 0, 0, 0, 0},
+};
+
+int main() {
+    LogParser parser;
+    int failed = 0;
+    for (const Case& c : kCases) {
+        std::tm tm{};
+        tm.tm_year = c.year - 1900;
+        tm.tm_mon = c.month - 1;
+        tm.tm_mday = c.day;
+        tm.tm_hour = c.hour;
+        tm.tm_min = c.minute;
+        tm.tm_sec = c.second;
+        const double wantSec = static_cast<double>(timegm(&tm));
+        const double wantMs = wantSec + c.ms / 1000.0;
+
+        const auto ts = parser.timestampOf(c.line);
+        if (!ts) {
+            std::printf("kein Zeitstempel: %s\n", c.line);
+            ++failed;
+            continue;
+        }
+        const double sec = Database::unixSeconds(*ts);
+        const double ms = Database::unixSecondsMs(*ts);
+        const bool ok = sec == wantSec && std::fabs(ms - wantMs) < 1e-6;
+        std::printf("%.23s  Sekunden %.0f (erwartet %.0f)  mit ms %.3f (erwartet %.3f)%s\n", c.line + 3,
+                    sec, wantSec, ms, wantMs, ok ? "" : "  FALSCH");
+        if (!ok) ++failed;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/*
+cptest.cpp
+==========
+
+Prüft, wann der DbWriter die Lesepositionen speichert:
+
+ 1. Die Queue läuft voll (tryPost ohne flush, bis es nicht mehr geht), der Aufrufer
+    hält das Ereignis und versucht es wie Merger und Replay erneut. Dabei geht nichts
+    verloren, also muss der Checkpoint danach gespeichert werden und drops() 0 bleiben.
+ 2. Ein Ereignis wird bei voller Queue mit post() endgültig verworfen. Der nächste
+    Checkpoint bleibt zurückgehalten; kommt danach kein Verlust mehr dazu, wird der
+    übernächste wieder gespeichert.
+
+Die DB zeigt auf einen nicht vorhandenen Socket, die Ereignisse landen im Spool eines
+temporären Verzeichnisses; dort liegt über STATE_DIRECTORY auch logparse.offsets.
+
+Aufruf: mmdvm-cptest
+  Exit-Code 1, wenn ein Checkpoint fehlt oder zu Unrecht gespeichert wurde.
+*/
+
+#include "../StatusPipeline.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace status;
+
+static std::string g_offsets;
+
+static std::string readOffsets() {
+    std::ifstream in(g_offsets);
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// Wartet, bis logparse.offsets die Position offset enthält
+static bool waitSaved(uint64_t offset) {
+    const std::string want = "\t" + std::to_string(offset) + "\n";
+    for (int i = 0; i < 500; ++i) {
+        if (readOffsets().find(want) != std::string::npos) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Wartet, bis der Writer alles Gepostete übernommen hat, und gibt ihm Zeit für den Checkpoint
+static void waitConsumed(const DbWriter& w, uint64_t posted) {
+    for (int i = 0; i < 500 && w.written() < posted; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+}
+
+static std::map<std::string, OffsetEntry> offsetsAt(uint64_t offset) {
+    return {{"/var/log/mmdvm/MMDVM.log", OffsetEntry{1, offset}}};
+}
+
+int main() {
+    char dir[] = "/tmp/mmdvm-cptest-XXXXXX";
+    if (!::mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    ::setenv("STATE_DIRECTORY", dir, 1);
+    g_offsets = std::string(dir) + "/logparse.offsets";
+
+    bool ok = true;
+    {
+        Database db(std::string(dir) + "/no-such.sock");
+        EventSpool spool;
+        if (!spool.open(std::string(dir) + "/events.spool", 64u << 20)) {
+            std::fprintf(stderr, "Spool lässt sich nicht anlegen\n");
+            return 2;
+        }
+        DbWriter w(db, &spool);
+
+        ParsedResult ev;
+        ev.kind = EventKind::End;
+        ev.mode = Mode::DMR;
+        ev.slot = 2;
+        ev.ts = std::chrono::system_clock::now();
+
+        // ---- 1: volle Queue, nichts verworfen ----
+        uint64_t posted = 0, queueFull = 0;
+        while (queueFull == 0 && posted < 200000) {
+            if (w.tryPost(ev)) ++posted; else ++queueFull;
+        }
+        for (int i = 0; i < 10000; ++i) {
+            while (!w.tryPost(ev)) { ++queueFull; w.flush(); std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+            ++posted;
+        }
+        w.checkpoint(offsetsAt(1000));
+        w.flush();
+        const bool saved = waitSaved(1000);
+        std::printf("volle Queue:  %llu gepostet, %llu mal voll, drops=%llu, Checkpoint %s\n",
+                    (unsigned long long)posted, (unsigned long long)queueFull,
+                    (unsigned long long)w.drops(), saved ? "gespeichert" : "FEHLT");
+        if (queueFull == 0) std::printf("Queue ist nie vollgelaufen\n");
+        if (!saved || w.drops() != 0 || queueFull == 0) ok = false;
+
+        // ---- 2: ein Ereignis verworfen ----
+        while (w.tryPost(ev)) ++posted;
+        const bool dropped = !w.post(ev);
+        w.checkpoint(offsetsAt(2000));
+        w.flush();
+        waitConsumed(w, posted);
+        const bool held = readOffsets().find("\t2000\n") == std::string::npos;
+
+        if (w.tryPost(ev)) ++posted;
+        w.checkpoint(offsetsAt(3000));
+        w.flush();
+        const bool resumed = waitSaved(3000);
+        std::printf("verworfen:    drops=%llu, Checkpoint danach %s, ohne weitere Verluste %s\n",
+                    (unsigned long long)w.drops(), held ? "zurückgehalten" : "GESPEICHERT",
+                    resumed ? "wieder gespeichert" : "FEHLT");
+        if (!dropped || w.drops() != 1 || !held || !resumed) ok = false;
+    }
+
+    ::unlink(g_offsets.c_str());
+    ::unlink((std::string(dir) + "/events.spool").c_str());
+    ::rmdir(dir);
+    return ok ? 0 : 1;
+}
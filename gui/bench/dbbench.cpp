@@ -0,0 +1,253 @@
+/*
+dbbench.cpp
+===========
+
+End-to-End-Benchmark des Schreibpfads gegen einen lokalen MariaDB-Server:
+Database::upsertStatus / insertLastHeard / applyBatch aus mmdvm-status und
+FMDatabase::insertEvent aus DVconfig. Gemessen werden Durchsatz, Latenz je
+Commit (Histogramm) und die InnoDB-Zähler des Servers.
+
+Aufruf: mmdvm-dbbench [Optionen]
+  --socket <pfad>       Socket des Servers (Default /run/mysqld/mysqld.sock);
+                        eine Wegwerf-Instanz startet ./mariadb-scratch.sh
+  --target <t>          lastheard | status | mixed | fm (Default mixed)
+  --events <n>          Ereignisse je Thread (Default 20000)
+  --batch <n>           Ereignisse je Transaktion (Default 32)
+  --txn <modus>         batch     = applyBatch, eine Transaktion je --batch Ereignisse
+                        autocommit = jedes Statement committet einzeln
+  --threads <n>         parallele Schreiber mit je eigener Verbindung (Default 1)
+
+Achtung: schreibt in die Tabellen der Datenbank mmdvmdb – nicht gegen die
+Datenbank eines laufenden Dashboards verwenden.
+*/
+
+#include "../StatusPipeline.h"
+
+#include "../parser/fmdatabase.h"
+
+#include <cstdio>
+
+using namespace status;
+
+struct Options {
+    std::string socket = "/run/mysqld/mysqld.sock";
+    std::string target = "mixed";
+    uint64_t events = 20000;
+    size_t batch = 32;
+    bool autocommit = false;
+    unsigned threads = 1;
+};
+
+// Latenz je Commit in Zweierpotenz-Klassen von Mikrosekunden
+struct Histogram {
+    static constexpr int kBuckets = 32;
+    uint64_t counts[kBuckets] = {};
+    std::vector<double> samples;   // µs, für Perzentile
+
+    void add(double us) {
+        int b = 0;
+        while (b + 1 < kBuckets && us >= static_cast<double>(1ull << (b + 1))) ++b;
+        ++counts[b];
+        samples.push_back(us);
+    }
+    void merge(const Histogram& o) {
+        for (int i = 0; i < kBuckets; ++i) counts[i] += o.counts[i];
+        samples.insert(samples.end(), o.samples.begin(), o.samples.end());
+    }
+    double pct(double q) const {
+        if (samples.empty()) return 0;
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(q * static_cast<double>(samples.size())))];
+    }
+    void print() {
+        std::sort(samples.begin(), samples.end());
+        uint64_t peak = 1;
+        for (uint64_t c : counts) peak = std::max(peak, c);
+        for (int i = 0; i < kBuckets; ++i) {
+            if (!counts[i]) continue;
+            const int bar = static_cast<int>(40 * counts[i] / peak);
+            std::printf("  %8llu .. %8llu us %9llu %s\n", static_cast<unsigned long long>(i ? 1ull << i : 0),
+                        static_cast<unsigned long long>(1ull << (i + 1)), static_cast<unsigned long long>(counts[i]),
+                        std::string(static_cast<size_t>(bar), '#').c_str());
+        }
+        std::printf("  p50=%s us p90=%s us p99=%s us max=%s us\n", fmtNum(pct(0.50)).c_str(), fmtNum(pct(0.90)).c_str(),
+                    fmtNum(pct(0.99)).c_str(), fmtNum(samples.empty() ? 0.0 : samples.back()).c_str());
+    }
+};
+
+// ---- Serverzähler über eine eigene Verbindung ----
+class ServerStats {
+public:
+    explicit ServerStats(const std::string& socket) {
+        conn_ = mysql_init(nullptr);
+        if (conn_ && !mysql_real_connect(conn_, nullptr, "mmdvm", "", "mmdvmdb", 0, socket.c_str(), 0)) {
+            std::fprintf(stderr, "[BENCH] stats connect failed: %s\n", mysql_error(conn_));
+            mysql_close(conn_);
+            conn_ = nullptr;
+        }
+    }
+    ~ServerStats() { if (conn_) mysql_close(conn_); }
+    ServerStats(const ServerStats&) = delete;
+    ServerStats& operator=(const ServerStats&) = delete;
+
+    bool ok() const { return conn_ != nullptr; }
+
+    std::map<std::string, long long> snapshot() {
+        std::map<std::string, long long> m;
+        if (!conn_) return m;
+        query("SHOW GLOBAL STATUS WHERE Variable_name IN ('Innodb_rows_inserted','Innodb_rows_updated',"
+              "'Innodb_rows_deleted','Innodb_data_fsyncs','Innodb_os_log_written','Com_commit','Questions')", m);
+        for (const char* t : {"lastheard", "status", "fmlastheard", "fmstatus"})
+            query((std::string("SELECT '") + t + ".rows', COUNT(*) FROM " + t).c_str(), m);
+        return m;
+    }
+
+private:
+    MYSQL* conn_ = nullptr;
+
+    void query(const char* q, std::map<std::string, long long>& out) {
+        if (mysql_query(conn_, q) != 0) return; // Tabelle evtl. noch nicht angelegt
+        if (MYSQL_RES* res = mysql_store_result(conn_)) {
+            while (MYSQL_ROW row = mysql_fetch_row(res)) {
+                if (row[0] && row[1]) out[row[0]] = std::atoll(row[1]);
+            }
+            mysql_free_result(res);
+        }
+    }
+};
+
+// ---- Ereignisse ----
+// Start/Ende-Paare aus einer kleinen Rufzeichen-Population, Betriebsarten reihum
+static std::vector<ParsedResult> makeEvents(uint64_t n, unsigned seed) {
+    static const char* const calls[] = {"DL1ABC", "OE3XYZ", "HB9ABC", "DB0XYZ", "PA3ABC", "G4KLX", "DJ0ABR", "ON4ABC"};
+    static const Mode modes[] = {Mode::DStar, Mode::YSF, Mode::DMR};
+    std::vector<ParsedResult> out;
+    out.reserve(n);
+    auto t = std::chrono::system_clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+        ParsedResult r;
+        const uint64_t q = (i / 2) + seed;
+        r.kind = (i & 1) ? EventKind::End : EventKind::Start;
+        r.mode = modes[q % 3];
+        r.source = (q & 4) ? Source::NET : Source::RF;
+        r.callsign = callsigns().intern(calls[q % std::size(calls)]);
+        if (r.mode == Mode::YSF) r.dgId = static_cast<int>(q % 100);
+        if (r.mode == Mode::DMR) r.slot = static_cast<int>(1 + (q & 1));
+        if (r.kind == EventKind::End) { r.durationSec = 1.0 + static_cast<double>(q % 30); r.berPct = 0.1 * static_cast<double>(q % 20); }
+        r.ts = t + std::chrono::milliseconds(i * 500);
+        out.push_back(r);
+    }
+    return out;
+}
+
+// Ein Schreiber mit eigener Verbindung; misst jede Transaktion bzw. jedes Statement
+static void runWriter(const Options& o, unsigned idx, Histogram& hist, uint64_t& written) {
+    using clock = std::chrono::steady_clock;
+    auto us = [](clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+
+    if (o.target == "fm") {
+        FMDatabase fm(o.socket);
+        for (uint64_t i = 0; i < o.events; ++i) {
+            const std::string call = "DL" + std::to_string((i / 2 + idx) % 10) + "FM" + static_cast<char>('A' + idx % 26);
+            const auto t0 = clock::now();
+            const bool ok = fm.insertEvent("12:00:00", (i & 1) ? "stop" : "start", call, "262", "fm-funknetz-01");
+            hist.add(us(clock::now() - t0));
+            if (ok) ++written;
+        }
+        return;
+    }
+
+    Database db(o.socket);
+    if (!db.ensure_conn()) return;
+
+    std::vector<ParsedResult> ev = makeEvents(o.events, idx * 7919);
+    if (o.target == "lastheard") {
+        ev.erase(std::remove_if(ev.begin(), ev.end(), [](const ParsedResult& r) { return r.kind != EventKind::End; }), ev.end());
+    }
+
+    for (size_t i = 0; i < ev.size(); i += o.batch) {
+        const size_t n = std::min(o.batch, ev.size() - i);
+        const ParsedResult* p = ev.data() + i;
+        const auto t0 = clock::now();
+        if (!o.autocommit) {
+            // Produktionspfad: ein Stapel = eine Transaktion (lastheard mehrzeilig, status zusammengefasst)
+            db.applyBatch(p, n);
+            hist.add(us(clock::now() - t0));
+            written += n;
+            continue;
+        }
+        // autocommit: jedes Ereignis einzeln, wie vor dem Zusammenfassen in Transaktionen
+        for (size_t k = 0; k < n; ++k) {
+            const ParsedResult& r = p[k];
+            const auto s0 = clock::now();
+            bool ok = true;
+            if (r.kind == EventKind::End && o.target != "status") ok = db.insertLastHeard(&r, 1);
+            if (ok && o.target != "lastheard") {
+                const bool active = r.kind == EventKind::Start;
+                ok = db.upsertStatus(r.mode, r.callsign, r.dgId, r.slot, r.source, active,
+                                     r.berPct, r.durationSec, r.ts);
+            }
+            hist.add(us(clock::now() - s0));
+            if (ok) ++written;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        if (a == "--socket" && i + 1 < argc)       o.socket = argv[++i];
+        else if (a == "--target" && i + 1 < argc)  o.target = argv[++i];
+        else if (a == "--events" && i + 1 < argc)  o.events = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--batch" && i + 1 < argc)   o.batch = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (a == "--threads" && i + 1 < argc) o.threads = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--txn" && i + 1 < argc) {
+            const std::string_view m = argv[++i];
+            if (m != "batch" && m != "autocommit") { std::cerr << "--txn batch|autocommit\n"; return 2; }
+            o.autocommit = m == "autocommit";
+        } else { std::cerr << "unbekannte Option: " << a << "\n"; return 2; }
+    }
+    if (o.target != "lastheard" && o.target != "status" && o.target != "mixed" && o.target != "fm") {
+        std::cerr << "--target lastheard|status|mixed|fm\n";
+        return 2;
+    }
+    if (o.target == "fm" && (!o.autocommit || o.batch != 32))
+        std::fprintf(stderr, "[BENCH] fm: insertEvent committet jedes Ereignis selbst, --batch/--txn werden ignoriert\n");
+
+    ServerStats stats(o.socket);
+    if (!stats.ok()) return 1;
+    // Tabellen anlegen lassen, damit die Zählung vorher vollständig ist
+    { Database db(o.socket); db.ensure_conn(); }
+    if (o.target == "fm") { FMDatabase fm(o.socket); }
+    const auto before = stats.snapshot();
+
+    std::vector<Histogram> hists(o.threads);
+    std::vector<uint64_t> written(o.threads, 0);
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < o.threads; ++t)
+            pool.emplace_back([&, t] { runWriter(o, t, hists[t], written[t]); });
+        for (auto& th : pool) th.join();
+    }
+    const double secs = std::max(1e-9, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    const auto after = stats.snapshot();
+
+    Histogram all;
+    uint64_t total = 0;
+    for (unsigned t = 0; t < o.threads; ++t) { all.merge(hists[t]); total += written[t]; }
+
+    std::printf("target=%s txn=%s batch=%zu threads=%u events=%llu\n", o.target.c_str(),
+                o.target == "fm" ? "autocommit" : (o.autocommit ? "autocommit" : "batch"),
+                o.batch, o.threads, static_cast<unsigned long long>(total));
+    std::printf("elapsed_s=%s events_per_s=%s commits=%zu\n", fmtNum(secs).c_str(),
+                fmtNum(static_cast<double>(total) / secs).c_str(), all.samples.size());
+    std::printf("commit latency:\n");
+    all.print();
+    std::printf("server counters (delta):\n");
+    for (const auto& [k, v] : after) {
+        auto it = before.find(k);
+        std::printf("  %-24s %lld\n", k.c_str(), v - (it != before.end() ? it->second : 0));
+    }
+    return 0;
+}
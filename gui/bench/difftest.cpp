@@ -0,0 +1,398 @@
+/*
+difftest.cpp
+============
+
+Differenztest für LogParser::processLine: der Schlüsselwort-Scanner gegen die
+std::regex-Kaskade, die er ersetzt hat (unten als legacy::LogParser aus dem
+alten mmdvm_status.cpp übernommen). Beide Parser lesen dieselben Zeilen, je
+Datei mit frischem Zustand; verglichen wird das Ergebnis jeder Zeile in einer
+gemeinsamen Textform (erzwungene Enden aus takePending() nicht, die hängen
+seit den Sitzungen je Logdatei/Zeitschlitz bewusst anders zusammen).
+
+Dazu eine feste Liste von Zeilen für jede Meldungsart, auch mit dem
+Schlüsselwort mitten in der Meldung: die Regexe fanden es an beliebiger
+Stelle, der Scanner verteilt nach dem ersten Zeichen und sucht erst danach
+weiter (LogParser::parseElsewhere). Beide müssen dasselbe liefern.
+
+Aufruf: mmdvm-difftest [Logdatei ...]
+  Exit-Code 1 bei Abweichungen. "make test" erzeugt vorher einen Korpus mit
+  mmdvm-loggen.
+*/
+
+#include "../StatusPipeline.h"
+
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <iomanip>
+
+using namespace status;
+
+namespace legacy {
+
+// ---- Der alte Parser (Stand vor dem Schlüsselwort-Scanner) ----
+
+struct ParsedResult {
+    std::string mode;      // D-Star, YSF, DMR, oder neue Betriebsart
+    std::string startEnd;  // Start, Ende, Mode, Info
+    std::string source;    // RF, NET oder "-"
+    std::string callsign;  // ggf. leer
+    std::optional<int> dgId;
+    std::optional<int> slot;
+    std::optional<double> durationSec;
+    std::optional<double> berPct;
+    std::optional<std::string> info;   // für z. B. "Verlinkt zu DCS001 R"
+};
+
+struct TransmissionState {
+    std::string mode;
+    std::string source;
+    std::string callsign;
+    std::optional<int> dgId;
+    std::optional<int> slot;
+};
+
+static std::string trim(const std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+static bool starts_with(const std::string& s, const char* pfx) {
+    size_t n = std::strlen(pfx);
+    return s.size() >= n && std::memcmp(s.data(), pfx, n) == 0;
+}
+
+class LogParser {
+public:
+    LogParser() {
+        rx.dstar_netStart = std::regex(R"(D-Star,\s+received\s+network\s+header\s+from\s+(\S+))");
+        rx.dstar_netEnd   = std::regex(R"(D-Star,\s+received\s+network\s+end\s+of\s+transmission\s+from\s+(\S+).*?,\s*([\d.]+)\s+seconds,.*?BER:\s*([\d.]+)%)");
+        rx.dstar_rfStart  = std::regex(R"(D-Star,\s+received\s+RF\s+(?:header|late entry)\s+from\s+(\S+))");
+        rx.dstar_rfEnd    = std::regex(R"(D-Star,\s+received\s+RF\s+end\s+of\s+transmission\s+from\s+(\S+).*?,\s*([\d.]+)\s+seconds,\s*BER:\s*([\d.]+)%)");
+
+        rx.ysf_netStartA  = std::regex(R"(YSF,\s+received\s+network\s+data\s+from\s+(\S+)\s+to\s+DG-ID\s+(\d+)\s+at\s+\S+)");
+        rx.ysf_netStartB  = std::regex(R"(YSF,\s+received\s+network\s+data\s+from\s+(\S+)\s+to\s+DG-ID\s+(\d+))");
+        rx.ysf_netEndA    = std::regex(R"(YSF,\s+network\s+watchdog\s+has\s+expired,\s*([\d.]+)\s+seconds(?:,[^,]*)?,\s*BER:\s*([\d.]+)%)");
+        rx.ysf_netEndB    = std::regex(R"(YSF,\s+received\s+network\s+end\s+of\s+transmission\s+from\s+(\S+)\s+to\s+DG-ID\s+(\d+),\s*([\d.]+)\s+seconds(?:,.*?BER:\s*([\d.]+)%)?)");
+        rx.ysf_rfStart    = std::regex(R"(YSF,\s+received\s+RF\s+header\s+from\s+(\S+)\s+to\s+DG-ID\s+(\d+))");
+        rx.ysf_rfEnd      = std::regex(R"(YSF,\s+received\s+RF\s+end\s+of\s+transmission\s+from\s+(\S+)\s+to\s+DG-ID\s+(\d+),\s*([\d.]+)\s+seconds(?:,.*?BER:\s*([\d.]+)%)?)");
+
+        rx.dmr_netStart   = std::regex(R"(DMR\s+Slot\s+(\d+),\s+received\s+network\s+voice\s+header\s+from\s+(\S+)\s+to\s+TG\s+(\d+))");
+        rx.dmr_netEnd     = std::regex(R"(DMR\s+Slot\s+(\d+),\s+received\s+network\s+end\s+of\s+voice\s+transmission\s+from\s+(\S+)\s+to\s+TG\s+(\d+),\s*([\d.]+)\s+seconds,.*?BER:\s*([\d.]+)%)");
+        rx.dmr_rfStart    = std::regex(R"(DMR\s+Slot\s+(\d+),\s+received\s+RF\s+voice\s+header\s+from\s+(\S+)\s+to\s+TG\s+(\d+))");
+        rx.dmr_rfEnd      = std::regex(R"(DMR\s+Slot\s+(\d+),\s+received\s+RF\s+end\s+of\s+voice\s+transmission\s+from\s+(\S+)\s+to\s+TG\s+(\d+),\s*([\d.]+)\s+seconds,\s*BER:\s*([\d.]+)%)");
+
+        rx.modeSet               = std::regex(R"(Mode\s+set\s+to\s+([A-Za-z0-9\-]+))");
+        rx.ysf_linked_to         = std::regex(R"(Linked\s+to\s+([^\r\n]+))");
+        rx.dmr_master_login      = std::regex(R"((\S+),\s+Logged\s+into\s+the\s+master\s+successfully)");
+        rx.dstar_slowdata_text   = std::regex(R"(D-Star,\s+network\s+slow\s+data\s+text\s*=\s*\"([^\"]+)\")");
+        rx.dstar_link_status_set = std::regex(R"(D-Star\s+link\s+status\s+set\s+to\s*\"([^\"]+)\")");
+    }
+
+    std::optional<ParsedResult> processLine(const std::string& line) {
+        std::smatch m;
+        if (std::regex_search(line, m, rx.modeSet)) {
+            const std::string newMode = m[1].str();
+            if (newMode == "Idle") open_.reset();
+            return info("Mode", newMode, "-", std::nullopt);
+        }
+        if (std::regex_search(line, m, rx.dstar_slowdata_text)) {
+            std::string txt = trim(m[1].str());
+            if (starts_with(txt, "Verlinkt zu ")) return info("Info", "D-Star", "NET", txt);
+        }
+        if (std::regex_search(line, m, rx.dstar_link_status_set)) {
+            std::string txt = trim(m[1].str());
+            if (starts_with(txt, "Verlinkt zu ")) return info("Info", "D-Star", "NET", txt);
+        }
+        if (std::regex_search(line, m, rx.ysf_linked_to))
+            return info("Info", "YSF", "-", "Linked to " + m[1].str());
+        if (line.find("Disconnect by remote command") != std::string::npos ||
+            line.find("Closing YSF network connection") != std::string::npos)
+            return info("Info", "YSF", "-", std::string("DISCONNECTED"));
+        if (std::regex_search(line, m, rx.dmr_master_login))
+            return info("Info", "DMR", "-", "Logged into master: " + m[1].str());
+
+        if (std::regex_search(line, m, rx.dstar_netStart))
+            return handleStart("D-Star", "NET", m[1].str(), std::nullopt);
+        if (std::regex_search(line, m, rx.dstar_netEnd))
+            return handleEnd("D-Star", "NET", m[1].str(), std::nullopt, std::stod(m[2].str()), std::stod(m[3].str()));
+        if (std::regex_search(line, m, rx.dstar_rfStart))
+            return handleStart("D-Star", "RF", m[1].str(), std::nullopt);
+        if (std::regex_search(line, m, rx.dstar_rfEnd))
+            return handleEnd("D-Star", "RF", m[1].str(), std::nullopt, std::stod(m[2].str()), std::stod(m[3].str()));
+
+        if (std::regex_search(line, m, rx.ysf_netStartA) || std::regex_search(line, m, rx.ysf_netStartB))
+            return handleStart("YSF", "NET", m[1].str(), std::stoi(m[2].str()));
+        if (std::regex_search(line, m, rx.ysf_netEndB))
+            return handleEnd("YSF", "NET", m[1].str(), std::stoi(m[2].str()), std::stod(m[3].str()), optBer(m, 4));
+        if (std::regex_search(line, m, rx.ysf_netEndA))
+            return handleEnd("YSF", "NET", "", std::nullopt, std::stod(m[1].str()), std::stod(m[2].str()));
+        if (std::regex_search(line, m, rx.ysf_rfStart))
+            return handleStart("YSF", "RF", m[1].str(), std::stoi(m[2].str()));
+        if (std::regex_search(line, m, rx.ysf_rfEnd))
+            return handleEnd("YSF", "RF", m[1].str(), std::stoi(m[2].str()), std::stod(m[3].str()), optBer(m, 4));
+
+        if (std::regex_search(line, m, rx.dmr_netStart))
+            return handleStart("DMR", "NET", m[2].str(), std::stoi(m[3].str()), std::stoi(m[1].str()));
+        if (std::regex_search(line, m, rx.dmr_netEnd))
+            return handleEnd("DMR", "NET", m[2].str(), std::stoi(m[3].str()),
+                             std::stod(m[4].str()), std::stod(m[5].str()), std::stoi(m[1].str()));
+        if (std::regex_search(line, m, rx.dmr_rfStart))
+            return handleStart("DMR", "RF", m[2].str(), std::stoi(m[3].str()), std::stoi(m[1].str()));
+        if (std::regex_search(line, m, rx.dmr_rfEnd))
+            return handleEnd("DMR", "RF", m[2].str(), std::stoi(m[3].str()),
+                             std::stod(m[4].str()), std::stod(m[5].str()), std::stoi(m[1].str()));
+        return std::nullopt;
+    }
+
+private:
+    struct Regexes {
+        std::regex dstar_netStart, dstar_netEnd, dstar_rfStart, dstar_rfEnd;
+        std::regex ysf_netStartA, ysf_netStartB, ysf_netEndA, ysf_netEndB, ysf_rfStart, ysf_rfEnd;
+        std::regex dmr_netStart, dmr_netEnd, dmr_rfStart, dmr_rfEnd;
+        std::regex modeSet, ysf_linked_to, dmr_master_login, dstar_slowdata_text, dstar_link_status_set;
+    } rx;
+
+    std::optional<TransmissionState> open_;
+
+    static std::optional<double> optBer(const std::smatch& m, size_t i) {
+        return (m.size() > i && m[i].matched) ? std::optional<double>(std::stod(m[i].str())) : std::nullopt;
+    }
+
+    static ParsedResult info(const char* startEnd, std::string mode, const char* source,
+                             std::optional<std::string> text) {
+        ParsedResult res;
+        res.startEnd = startEnd;
+        res.mode = std::move(mode);
+        res.source = source;
+        res.info = std::move(text);
+        return res;
+    }
+
+    static std::string sanitizeCallsign(const std::string& in) {
+        std::string s = trim(in);
+        size_t p = s.find_first_of("/ ");
+        if (p != std::string::npos) s = s.substr(0, p);
+        return s;
+    }
+
+    std::optional<ParsedResult> handleStart(const std::string& mode, const std::string& source,
+                                            const std::string& callsign, std::optional<int> dgId,
+                                            std::optional<int> slotId = std::nullopt) {
+        std::string cs = sanitizeCallsign(callsign);
+        if (!cs.empty() && !isValidCallsign(cs)) return std::nullopt;
+        open_ = TransmissionState{mode, source, cs, dgId, slotId};
+
+        ParsedResult res;
+        res.mode = mode;
+        res.startEnd = "Start";
+        res.source = source;
+        res.callsign = cs;
+        res.dgId = dgId;
+        res.slot = slotId;
+        return res;
+    }
+
+    std::optional<ParsedResult> handleEnd(const std::string& mode, const std::string& source,
+                                          const std::string& callsign, std::optional<int> dgId,
+                                          std::optional<double> durationSec, std::optional<double> berPct,
+                                          std::optional<int> slotId = std::nullopt) {
+        std::string cs = sanitizeCallsign(callsign);
+        if (!cs.empty() && !isValidCallsign(cs)) return std::nullopt;
+
+        ParsedResult res;
+        res.mode = mode;
+        res.startEnd = "Ende";
+        res.source = source;
+        res.callsign = cs;
+        res.dgId = dgId;
+        res.slot = slotId;
+        if (open_) {
+            if (res.callsign.empty()) res.callsign = open_->callsign;
+            if (!res.dgId) res.dgId = open_->dgId;
+            if (!res.slot) res.slot = open_->slot;
+            open_.reset();
+        }
+        res.durationSec = durationSec;
+        res.berPct = berPct;
+        return res;
+    }
+};
+
+} // namespace legacy
+
+// ---- Gemeinsame Textform ----
+// Die alten Info-Texte werden auf Link/Unlink mit dem reinen Reflektor-/Servernamen
+// abgebildet, Betriebsarten auf die Namen aus modeName().
+
+static std::string optStr(const std::optional<int>& v) { return v ? std::to_string(*v) : "-"; }
+static std::string optStr(const std::optional<double>& v) { return v ? fmtNum(*v) : "-"; }
+
+static std::string canonical(const std::optional<legacy::ParsedResult>& r) {
+    if (!r) return "none";
+    std::string kind = r->startEnd, info;
+    if (r->startEnd == "Info" && r->info) {
+        static const char* const prefixes[] = {"Verlinkt zu ", "Linked to ", "Logged into master: "};
+        kind = "Link";
+        info = *r->info;
+        if (info == "DISCONNECTED") { kind = "Unlink"; info.clear(); }
+        for (const char* p : prefixes)
+            if (legacy::starts_with(info, p)) info.erase(0, std::strlen(p));
+    }
+    const std::string mode(modeName(modeFromName(r->mode)));
+    return kind + "|" + mode + "|" + r->source + "|" + r->callsign + "|" + optStr(r->dgId) + "|" +
+           optStr(r->slot) + "|" + optStr(r->durationSec) + "|" + optStr(r->berPct) + "|" + info;
+}
+
+static std::string canonical(const std::optional<ParsedResult>& r) {
+    if (!r) return "none";
+    std::string kind(kindName(r->kind));
+    if (r->kind == EventKind::Link) kind = "Link";
+    if (r->kind == EventKind::Unlink) kind = "Unlink";
+    return kind + "|" + std::string(modeName(r->mode)) + "|" + std::string(sourceName(r->source)) + "|" +
+           std::string(callsigns().str(r->callsign)) + "|" + optStr(r->dgId) + "|" + optStr(r->slot) + "|" +
+           optStr(r->durationSec) + "|" + optStr(r->berPct) + "|" + std::string(r->info.view());
+}
+
+struct Tally {
+    uint64_t lines = 0, events = 0, mismatches = 0;
+};
+
+static void report(const char* what, const std::string& line, const std::string& want, const std::string& got) {
+    std::printf("%s\n  Zeile: %s\n  alt:   %s\n  neu:   %s\n", what, line.c_str(), want.c_str(), got.c_str());
+}
+
+// Beide Parser über dieselben Zeilen; Abweichungen zählen
+static void compareLines(const std::vector<std::string>& lines, Tally& t) {
+    legacy::LogParser oldParser;
+    LogParser newParser;
+    std::vector<ParsedResult> pending;
+    for (const auto& line : lines) {
+        const std::string want = canonical(oldParser.processLine(line));
+        const std::string got = canonical(newParser.processLine(line));
+        newParser.takePending(pending);
+        ++t.lines;
+        if (want != "none") ++t.events;
+        if (want != got) {
+            if (++t.mismatches <= 20) report("ABWEICHUNG", line, want, got);
+        }
+    }
+}
+
+static const char* const kTs = "2025-10-12 10:00:00.000 ";
+
+// Jede Meldungsart mindestens einmal, mit den Varianten der Regexe
+static std::vector<std::string> handcraftedLines() {
+    const std::string ts = kTs;
+    return {
+        "M: " + ts + "Mode set to D-Star",
+        "M: " + ts + "D-Star, received RF header from DL1ABC  /ID51 to CQCQCQ",
+        "M: " + ts + "D-Star, received RF end of transmission from DL1ABC  /ID51 to CQCQCQ, 4.2 seconds, BER: 0.3%",
+        "M: " + ts + "D-Star, received RF late entry from DL2ABC  /ID51 to CQCQCQ",
+        "M: " + ts + "D-Star, received RF end of transmission from DL2ABC  /ID51 to CQCQCQ, 1.0 seconds, BER: 1.5%",
+        "M: " + ts + "D-Star, received network header from DL3ABC  /INFO to CQCQCQ via DCS001 R",
+        "M: " + ts + "D-Star, received network end of transmission from DL3ABC  /INFO to CQCQCQ, 12.3 seconds, 0% packet loss, BER: 0.0%",
+        "M: " + ts + "D-Star, network slow data text = \"Verlinkt zu DCS001 R\"",
+        "M: " + ts + "D-Star, network slow data text = \"Hallo Welt\"",
+        "M: " + ts + "D-Star link status set to \"Verlinkt zu XLX262 B\"",
+        "M: " + ts + "Mode set to System Fusion",
+        "M: " + ts + "Mode set to YSF",
+        "M: " + ts + "YSF, received RF header from DL4ABC     to DG-ID 0",
+        "M: " + ts + "YSF, received RF end of transmission from DL4ABC     to DG-ID 0, 3.4 seconds, BER: 0.5%",
+        "M: " + ts + "YSF, received RF end of transmission from DL4ABC     to DG-ID 0, 3.4 seconds",
+        "M: " + ts + "YSF, received network data from DL5ABC     to DG-ID 20 at DE-Germany",
+        "M: " + ts + "YSF, received network data from DL5ABC     to DG-ID 20",
+        "M: " + ts + "YSF, received network end of transmission from DL5ABC     to DG-ID 20, 8.1 seconds, 0% packet loss, BER: 0.0%",
+        "M: " + ts + "YSF, received network data from DL6ABC     to DG-ID 20 at DE-Germany",
+        "M: " + ts + "YSF, network watchdog has expired, 5.0 seconds, 0% packet loss, BER: 0.0%",
+        "M: " + ts + "Linked to DE-C4FM-Germany",
+        "M: " + ts + "XLX, Linked to XLX262 B",
+        "M: " + ts + "Disconnect by remote command",
+        "M: " + ts + "Closing YSF network connection",
+        "M: " + ts + "Mode set to DMR",
+        "M: " + ts + "DMR Slot 1, received RF voice header from DL7ABC to TG 9",
+        "M: " + ts + "DMR Slot 1, received RF end of voice transmission from DL7ABC to TG 9, 2.5 seconds, BER: 0.2%",
+        "M: " + ts + "DMR Slot 2, received network voice header from DL8ABC to TG 262",
+        "M: " + ts + "DMR Slot 2, received network end of voice transmission from DL8ABC to TG 262, 6.0 seconds, 1% packet loss, BER: 0.1%",
+        "M: " + ts + "DMR Slot 2, received network voice header from 2621234 to TG 262",
+        "I: " + ts + "BM_2621_Germany, Logged into the master successfully",
+        "M: " + ts + "Mode set to Idle",
+        "M: " + ts + "Mode set to POCSAG",
+        "M: " + ts + "Mode set to M17",
+        "M: " + ts + "DMR Slot 2, received network voice header from X to TG 262",
+        "M: " + ts + "Opening the MMDVM",
+        "garbage without timestamp",
+        "",
+    };
+}
+
+// Schlüsselwort nicht am Anfang der Meldung: der alte Parser muss sie erkennen
+static std::vector<std::string> notAtStartLines() {
+    const std::string ts = kTs;
+    return {
+        "M: " + ts + "Info: Mode set to DMR",
+        "M: " + ts + "Info: D-Star, received RF header from DL1ABC  /ID51 to CQCQCQ",
+        "M: " + ts + "Info: D-Star, network slow data text = \"Verlinkt zu DCS001 R\"",
+        "M: " + ts + "Info: YSF, received RF header from DL4ABC     to DG-ID 0",
+        "M: " + ts + "Info: DMR Slot 2, received network voice header from DL8ABC to TG 262",
+        "M: " + ts + "(repeat) DMR Slot 2, received network end of voice transmission from DL8ABC to TG 262, 6.0 seconds, 1% packet loss, BER: 0.1%",
+        "M: " + ts + "YSF, DMR Slot 1, received RF voice header from DL7ABC to TG 9",
+        "M: " + ts + "Info: D-Star link status set to \"Verlinkt zu XLX262 B\"",
+        "M: " + ts + "Info: YSF, received network data from DL5ABC     to DG-ID 20 at DE-Germany",
+    };
+}
+
+static bool readLines(const char* path, std::vector<std::string>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        out.push_back(line);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Tally corpus, fixed;
+    bool ok = true;
+
+    std::vector<std::string> lines;
+    for (int i = 1; i < argc; ++i) {
+        if (!readLines(argv[i], lines)) {
+            std::fprintf(stderr, "kann %s nicht lesen\n", argv[i]);
+            return 2;
+        }
+        compareLines(lines, corpus);
+    }
+    compareLines(handcraftedLines(), fixed);
+
+    Tally notAtStart;
+    for (const auto& line : notAtStartLines()) {
+        legacy::LogParser oldParser;
+        if (!oldParser.processLine(line)) {
+            report("NICHT AM ANFANG, alt erkennt nichts", line, "none", "-");
+            ok = false;
+        }
+        compareLines({line}, notAtStart);
+    }
+
+    std::printf("Korpus:     %llu Zeilen, %llu Ereignisse, %llu Abweichungen\n",
+                (unsigned long long)corpus.lines, (unsigned long long)corpus.events,
+                (unsigned long long)corpus.mismatches);
+    std::printf("Handliste:  %llu Zeilen, %llu Ereignisse, %llu Abweichungen\n",
+                (unsigned long long)fixed.lines, (unsigned long long)fixed.events,
+                (unsigned long long)fixed.mismatches);
+    std::printf("Nicht am Anfang: %llu Zeilen, %llu Abweichungen\n",
+                (unsigned long long)notAtStart.lines, (unsigned long long)notAtStart.mismatches);
+
+    if (argc > 1 && corpus.events == 0) {
+        std::printf("Korpus ohne ein einziges Ereignis\n");
+        ok = false;
+    }
+    return (ok && corpus.mismatches == 0 && fixed.mismatches == 0 && notAtStart.mismatches == 0) ? 0 : 1;
+}
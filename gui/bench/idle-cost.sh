@@ -0,0 +1,52 @@
+#!/bin/bash
+# Ruhelast laufender Dienste: Aufwachvorgänge pro Sekunde (Kontextwechsel aller Threads,
+# freiwillig + unfreiwillig) und RSS. Vorher/nachher auf demselben Gerät und bei
+# schweigendem Repeater messen.
+#
+#   ./idle-cost.sh [sekunden] [prozessname ...]
+#   Default: 60 s, mmdvm-status DVconfig
+#
+# Beispiel: getrennte Dienste gegen DVconfig --with-status (mmdvm-status.service aus)
+
+set -e
+
+SECS="${1:-60}"
+shift || true
+NAMES=("$@")
+[ ${#NAMES[@]} -eq 0 ] && NAMES=(mmdvm-status DVconfig)
+
+# Summe der Kontextwechsel über alle Threads eines Prozesses
+switches() {
+    local sum=0 n
+    for f in /proc/"$1"/task/*/status; do
+        n=$(awk '/ctxt_switches/ { s += $2 } END { print s + 0 }' "$f" 2>/dev/null) || n=0
+        sum=$((sum + n))
+    done
+    echo "$sum"
+}
+
+declare -A PIDS BEFORE
+for name in "${NAMES[@]}"; do
+    pid=$(pgrep -xo "$name" || true)
+    [ -n "$pid" ] || { echo "$name: läuft nicht"; continue; }
+    PIDS[$name]=$pid
+    BEFORE[$name]=$(switches "$pid")
+done
+[ ${#PIDS[@]} -gt 0 ] || exit 1
+
+sleep "$SECS"
+
+total_w=0
+total_rss=0
+printf "%-14s %8s %12s %10s\n" process threads wakeups/s rss_kB
+for name in "${!PIDS[@]}"; do
+    pid=${PIDS[$name]}
+    after=$(switches "$pid")
+    threads=$(ls /proc/"$pid"/task | wc -l)
+    rss=$(awk '/^VmRSS:/ { print $2 }' /proc/"$pid"/status)
+    w=$(awk -v a="$after" -v b="${BEFORE[$name]}" -v s="$SECS" 'BEGIN { printf "%.2f", (a - b) / s }')
+    printf "%-14s %8d %12s %10d\n" "$name" "$threads" "$w" "$rss"
+    total_w=$(awk -v t="$total_w" -v w="$w" 'BEGIN { printf "%.2f", t + w }')
+    total_rss=$((total_rss + rss))
+done
+printf "%-14s %8s %12s %10d\n" total "" "$total_w" "$total_rss"
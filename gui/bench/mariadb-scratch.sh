@@ -0,0 +1,49 @@
+#!/bin/bash
+# Wegwerf-MariaDB für mmdvm-dbbench: eigenes Datenverzeichnis, nur Unix-Socket,
+# läuft unter dem aktuellen Benutzer. Die Datenbank des Dashboards bleibt unberührt.
+#
+#   ./mariadb-scratch.sh start [dir]   -> Socket: <dir>/mysqld.sock
+#   ./mariadb-scratch.sh stop  [dir]   -> Server beenden, Verzeichnis löschen
+
+set -e
+
+DIR="${2:-/tmp/mmdvm-dbbench}"
+SOCK="$DIR/mysqld.sock"
+PID="$DIR/mysqld.pid"
+
+case "$1" in
+start)
+    mkdir -p "$DIR/data"
+    mariadb-install-db --no-defaults --datadir="$DIR/data" --user="$(id -un)" \
+        --auth-root-authentication-method=socket --skip-test-db >/dev/null
+    mariadbd --no-defaults --datadir="$DIR/data" --socket="$SOCK" --pid-file="$PID" \
+        --skip-networking --user="$(id -un)" --log-error="$DIR/error.log" &
+
+    for _ in $(seq 1 50); do
+        [ -S "$SOCK" ] && break
+        sleep 0.2
+    done
+    [ -S "$SOCK" ] || { echo "MariaDB startet nicht, siehe $DIR/error.log"; exit 1; }
+
+    mariadb -S "$SOCK" -u "$(id -un)" <<'EOF'
+CREATE DATABASE IF NOT EXISTS mmdvmdb;
+CREATE USER IF NOT EXISTS 'mmdvm'@'localhost' IDENTIFIED BY '';
+GRANT ALL PRIVILEGES ON mmdvmdb.* TO 'mmdvm'@'localhost';
+GRANT PROCESS ON *.* TO 'mmdvm'@'localhost';
+FLUSH PRIVILEGES;
+EOF
+    echo "$SOCK"
+    ;;
+stop)
+    [ -f "$PID" ] && kill "$(cat "$PID")" || true
+    for _ in $(seq 1 50); do
+        [ -S "$SOCK" ] || break
+        sleep 0.2
+    done
+    rm -rf "$DIR"
+    ;;
+*)
+    echo "Aufruf: $0 start|stop [dir]"
+    exit 2
+    ;;
+esac
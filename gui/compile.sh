@@ -1 +1 @@
- g++ -std=c++17 -O2 -Wall -o /usr/local/bin/mmdvm-status mmdvm_status.cpp -lmariadbclient
+ g++ -std=c++17 -O2 -Wall -o /usr/local/bin/mmdvm-status mmdvm_status.cpp StatusPipeline.cpp -lmysqlclient -lz
@@ -11,6 +11,9 @@ function response($ok, $payload = []) {
 
 $CONFIG_PASSWORD = 'setuppassword';
 
+// Weckruf an DVconfig (parser/ConfigNotify.h), damit es config_inbox sofort liest
+$DVCONFIG_NOTIFY = 'udg:///run/mmdvm-dvconfig/notify.sock';
+
 // Nur POST akzeptieren
 if (($_SERVER['REQUEST_METHOD'] ?? '') !== 'POST') {
   http_response_code(405);
@@ -139,6 +142,15 @@ try {
     ':bm_api_key'       => ($data['BmApiKey'] ?? '') ?: null,
   ]);
 
+  // erst nach dem Schreiben wecken; klappt das nicht, findet DVconfig die Änderung
+  // bei seiner langsamen Abfrage von config_inbox
+  $notified = false;
+  $sock = @stream_socket_client($DVCONFIG_NOTIFY, $errno, $errstr, 1);
+  if ($sock) {
+    $notified = @fwrite($sock, "config_inbox") !== false;
+    fclose($sock);
+  }
+
   $count = 0;
   foreach ($expected as $k) {
     if ($data[$k] !== null && $data[$k] !== '') $count++;
@@ -147,6 +159,7 @@ try {
     'stored_table' => 'config_inbox',
     'is_new' => 'GUI',
     'count' => $count,
+    'notified' => $notified,
   ]);
 
 } catch (Throwable $e) {
@@ -0,0 +1,534 @@
+/*
+mmdvm_loggen.cpp
+================
+
+erzeugt synthetische Logdateien von MMDVMHost, YSFGateway und DMRGateway
+in genau den Formaten, die mmdvm-status auswertet. Gedacht für Lasttests
+von Parser und DB-Writer, für --import und für --replay.
+
+Aufruf: mmdvm-loggen [Optionen]
+  --out <dir|->           Verzeichnis für MMDVM-/YSFGateway-/DMRGateway-<Datum>.log
+                          oder "-" = alles nach stdout (Default)
+  --seed <n>              Startwert des Zufallsgenerators (Default 1);
+                          gleiche Optionen + gleicher Seed = gleiche Ausgabe
+  --start <YYYY-MM-DD>    erster simulierter Tag ab 00:00 UTC (Default heute)
+  --hours <h>             simulierte Dauer in Stunden (Default 24)
+  --size <n[k|M|G]>       statt --hours: erzeugen, bis so viele Bytes geschrieben sind
+  --qso-rate <n>          Übertragungen pro Stunde (Default 120)
+  --median-duration <s>   Median der Übertragungsdauer, log-normalverteilt (Default 8)
+  --callsigns <n>         Größe der Rufzeichen-Population, Zipf-verteilt (Default 500)
+  --mix <dstar,ysf,dmr>   Anteile der Betriebsarten (Default 30,30,40)
+  --net-share <p>         Anteil Netzwerk-Übertragungen in Prozent (Default 70)
+  --duplex                DMR mit zwei gleichzeitig belegten Zeitschlitzen
+  --noise <n>             irrelevante Zeilen je Übertragung im Mittel (Default 5)
+  --links-per-hour <n>    Reflektor-/Master-Wechsel pro Stunde (Default 2)
+  --rate <lines/s>        Live-Betrieb: Zeilen mit aktueller Uhrzeit in diesem Takt
+                          an die heutigen Dateien anhängen (ohne --hours/--size endlos)
+
+Beispiele:
+  mmdvm-loggen --size 1G --qso-rate 3000 --out /tmp/corpus
+  mmdvm-loggen --out /var/log/mmdvm --rate 200 --duplex
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <queue>
+#include <random>
+#include <algorithm>
+#include <optional>
+#include <filesystem>
+
+// ---- Optionen ----
+struct Options {
+    std::string out = "-";
+    uint64_t seed = 1;
+    std::optional<int64_t> startDay;    // Tage seit 1970-01-01
+    std::optional<double> hours;
+    uint64_t size = 0;                  // 0 = unbegrenzt
+    double qsoRate = 120;               // pro Stunde
+    double medianDuration = 8;          // Sekunden
+    size_t callsigns = 500;
+    double mix[3] = {30, 30, 40};       // D-Star, YSF, DMR
+    double netShare = 70;
+    bool duplex = false;
+    double noise = 5;
+    double linksPerHour = 2;
+    double rate = 0;                    // Zeilen/s, 0 = kein Live-Betrieb
+};
+
+// Tage seit 1970-01-01 für ein gregorianisches Datum (days_from_civil nach H. Hinnant)
+static int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Umkehrung: Datum zu Tagen seit 1970-01-01 (civil_from_days)
+static void civilFromDays(int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe) + static_cast<int>(era) * 400 + (m <= 2);
+}
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "1G", "500M", "64k" → Bytes
+static uint64_t parseSize(const char* s) {
+    char* end = nullptr;
+    double v = std::strtod(s, &end);
+    switch (end ? *end : '\0') {
+        case 'k': case 'K': v *= 1024.0; break;
+        case 'm': case 'M': v *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': v *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+    }
+    return v > 0 ? static_cast<uint64_t>(v) : 0;
+}
+
+static bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--duplex") { o.duplex = true; continue; }
+        if (!hasValue) { std::cerr << "unbekannte oder unvollständige Option: " << a << "\n"; return false; }
+        const char* v = argv[++i];
+        if      (a == "--out")             o.out = v;
+        else if (a == "--seed")            o.seed = std::strtoull(v, nullptr, 10);
+        else if (a == "--hours")           o.hours = std::atof(v);
+        else if (a == "--size")            o.size = parseSize(v);
+        else if (a == "--qso-rate")        o.qsoRate = std::max(0.01, std::atof(v));
+        else if (a == "--median-duration") o.medianDuration = std::max(0.3, std::atof(v));
+        else if (a == "--callsigns")       o.callsigns = std::max<size_t>(1, std::strtoul(v, nullptr, 10));
+        else if (a == "--net-share")       o.netShare = std::clamp(std::atof(v), 0.0, 100.0);
+        else if (a == "--noise")           o.noise = std::max(0.0, std::atof(v));
+        else if (a == "--links-per-hour")  o.linksPerHour = std::max(0.0, std::atof(v));
+        else if (a == "--rate")            o.rate = std::max(0.0, std::atof(v));
+        else if (a == "--start") {
+            int y = 0; unsigned m = 0, d = 0;
+            if (std::sscanf(v, "%d-%u-%u", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+                std::cerr << "--start erwartet YYYY-MM-DD\n";
+                return false;
+            }
+            o.startDay = daysFromCivil(y, m, d);
+        } else if (a == "--mix") {
+            if (std::sscanf(v, "%lf,%lf,%lf", &o.mix[0], &o.mix[1], &o.mix[2]) != 3 ||
+                o.mix[0] + o.mix[1] + o.mix[2] <= 0) {
+                std::cerr << "--mix erwartet dstar,ysf,dmr\n";
+                return false;
+            }
+        } else {
+            std::cerr << "unbekannte Option: " << a << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---- Ausgabe ----
+// Logdateien der drei Programme
+enum Stream : uint8_t { kMMDVM = 0, kYSFGateway = 1, kDMRGateway = 2 };
+static const char* const kStreamNames[3] = {"MMDVM", "YSFGateway", "DMRGateway"};
+
+// Schreibt Zeilen im Format "X: YYYY-MM-DD HH:MM:SS.mmm <Text>" nach stdout oder in
+// die Tagesdateien eines Verzeichnisses (neuer Dateiname ab 00:00 UTC wie bei MMDVMHost).
+class LogSink {
+public:
+    explicit LogSink(std::string dir) : dir_(std::move(dir)) {}
+    ~LogSink() {
+        for (auto& f : files_) if (f.fp) std::fclose(f.fp);
+    }
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    bool write(Stream stream, int64_t ms, char level, std::string_view text) {
+        const int64_t day = floorDiv(ms, 86400000);
+        const int64_t msOfDay = ms - day * 86400000;
+        FILE* fp = fileFor(stream, day);
+        if (!fp) return false;
+
+        int y; unsigned mo, d;
+        civilFromDays(day, y, mo, d);
+        const int hh = static_cast<int>(msOfDay / 3600000), mi = static_cast<int>(msOfDay / 60000 % 60);
+        const int ss = static_cast<int>(msOfDay / 1000 % 60), mss = static_cast<int>(msOfDay % 1000);
+
+        char prefix[40];
+        const int n = std::snprintf(prefix, sizeof(prefix), "%c: %04d-%02u-%02u %02d:%02d:%02d.%03d ",
+                                    level, y, mo, d, hh, mi, ss, mss);
+        std::fwrite(prefix, 1, static_cast<size_t>(n), fp);
+        std::fwrite(text.data(), 1, text.size(), fp);
+        std::fputc('\n', fp);
+        bytes_ += static_cast<uint64_t>(n) + text.size() + 1;
+        return true;
+    }
+
+    void flush() {
+        for (auto& f : files_) if (f.fp) std::fflush(f.fp);
+    }
+
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    struct File {
+        FILE* fp = nullptr;
+        int64_t day = -1;
+    };
+    std::string dir_;
+    File files_[3];
+    uint64_t bytes_ = 0;
+
+    static int64_t floorDiv(int64_t a, int64_t b) { return a / b - (a % b != 0 && (a < 0) != (b < 0)); }
+
+    FILE* fileFor(Stream stream, int64_t day) {
+        if (dir_ == "-") {
+            File& f = files_[0];
+            if (!f.fp) { f.fp = stdout; std::setvbuf(stdout, nullptr, _IOFBF, 1 << 20); }
+            return f.fp;
+        }
+        File& f = files_[stream];
+        if (f.fp && f.day == day) return f.fp;
+        if (f.fp) std::fclose(f.fp);
+
+        int y; unsigned m, d;
+        civilFromDays(day, y, m, d);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s-%04d-%02u-%02u.log", kStreamNames[stream], y, m, d);
+        const std::string path = (std::filesystem::path(dir_) / name).string();
+        f.fp = std::fopen(path.c_str(), "a");
+        f.day = day;
+        if (!f.fp) { std::cerr << "kann " << path << " nicht öffnen: " << std::strerror(errno) << "\n"; return nullptr; }
+        std::setvbuf(f.fp, nullptr, _IOFBF, 1 << 20);
+        return f.fp;
+    }
+};
+
+// ---- Verkehrsmodell ----
+// Übertragungen kommen als Poisson-Prozess mit qsoRate pro Stunde, die Dauer ist
+// log-normalverteilt (viele kurze Durchgänge, wenige lange), die Rufzeichen folgen einer
+// Zipf-Verteilung (wenige Vielsprecher). MMDVMHost arbeitet immer nur in einer Betriebsart:
+// vor einem Wechsel kommt "Mode set to", nach der Hang-Zeit "Mode set to Idle". Nur DMR
+// im Duplex-Betrieb belegt zwei Zeitschlitze gleichzeitig.
+class TrafficModel {
+public:
+    struct Line {
+        int64_t ms;
+        uint64_t seq;           // stabile Reihenfolge bei gleichem Zeitstempel
+        Stream stream;
+        char level;
+        std::string text;
+    };
+
+    TrafficModel(const Options& o, int64_t startMs)
+        : o_(o), rng_(o.seed), t_(startMs), lastEnd_(startMs), nextLink_(startMs) {
+        makeCallsigns();
+        double sum = 0;
+        for (size_t k = 1; k <= callsigns_.size(); ++k) { sum += 1.0 / static_cast<double>(k); zipf_.push_back(sum); }
+        scheduleLink();
+    }
+
+    // Erzeugt die nächste Übertragung (und was davor fällig ist). Zeilen vor safeMs()
+    // stehen danach endgültig fest.
+    void step() {
+        std::exponential_distribution<double> gap(o_.qsoRate / 3600.0);
+        int64_t start = t_ + static_cast<int64_t>(gap(rng_) * 1000.0) + 1;
+
+        const int mode = pickMode();
+        int slot = 0;
+        const int64_t busyAll = std::max(busy_[0], busy_[1]);
+        if (mode == kDMR && o_.duplex && currentMode_ == kDMR) {
+            // der freie Zeitschlitz darf sich mit dem anderen überlappen
+            slot = busy_[0] <= busy_[1] ? 0 : 1;
+            start = std::max(start, busy_[slot] + 200);
+        } else {
+            if (mode == kDMR) slot = uniform(0, 1);
+            start = std::max(start, busyAll + 300);
+        }
+
+        while (nextLink_ < start) {
+            emitLink(nextLink_);
+            scheduleLink();
+        }
+
+        // Hang-Zeit abgelaufen → Idle, danach Betriebsart neu setzen
+        if (currentMode_ != kIdle && start > lastEnd_ + kHangMs) {
+            push(lastEnd_ + kHangMs, kMMDVM, 'M', "Mode set to Idle");
+            currentMode_ = kIdle;
+        }
+        if (currentMode_ != mode) {
+            push(start - uniform(10, 80), kMMDVM, 'M', std::string("Mode set to ") + kModeNames[mode]);
+            currentMode_ = mode;
+        }
+
+        const int64_t end = start + durationMs();
+        transmission(mode, slot, start, end);
+        busy_[mode == kDMR ? slot : 0] = end;
+        if (mode != kDMR) busy_[1] = end;
+        lastEnd_ = std::max(lastEnd_, end);
+        t_ = start;
+    }
+
+    // Alle später erzeugten Zeilen liegen nicht vor diesem Zeitpunkt
+    int64_t safeMs() const { return t_ - 100; }
+    int64_t now() const { return t_; }
+
+    bool pop(int64_t before, Line& out) {
+        if (heap_.empty() || heap_.top().ms >= before) return false;
+        out = heap_.top();
+        heap_.pop();
+        return true;
+    }
+
+private:
+    enum ModeIdx { kDStar = 0, kYSF = 1, kDMR = 2, kIdle = 3 };
+    static constexpr const char* kModeNames[3] = {"D-Star", "YSF", "DMR"};
+    static constexpr int64_t kHangMs = 10000;
+
+    struct Later {
+        bool operator()(const Line& a, const Line& b) const {
+            return a.ms != b.ms ? a.ms > b.ms : a.seq > b.seq;
+        }
+    };
+
+    const Options& o_;
+    std::mt19937_64 rng_;
+    std::priority_queue<Line, std::vector<Line>, Later> heap_;
+    uint64_t seq_ = 0;
+    int64_t t_;                          // Beginn der zuletzt erzeugten Übertragung
+    int64_t lastEnd_;
+    int64_t busy_[2] = {0, 0};           // belegt bis (je DMR-Zeitschlitz, sonst beide gleich)
+    int64_t nextLink_;
+    int currentMode_ = kIdle;
+    std::vector<std::string> callsigns_;
+    std::vector<double> zipf_;           // kumulierte Gewichte 1/k
+
+    void push(int64_t ms, Stream stream, char level, std::string text) {
+        heap_.push(Line{ms, seq_++, stream, level, std::move(text)});
+    }
+
+    int uniform(int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng_); }
+    double uniformReal(double lo, double hi) { return std::uniform_real_distribution<double>(lo, hi)(rng_); }
+    bool chance(double pct) { return uniformReal(0, 100) < pct; }
+
+    // Rufzeichen wie DL1ABC, OE3XYZ, HB9ABC, M0ABC; dazu ein paar YSF-Zahlen-IDs
+    void makeCallsigns() {
+        static const char* const prefixes[] = {"DL", "DO", "DB", "DK", "DG", "DJ", "OE", "HB9", "PA", "ON",
+                                               "G", "M0", "F", "I", "SP", "OK", "EA", "OZ", "SM", "LA"};
+        std::vector<std::string> seen;
+        while (callsigns_.size() < o_.callsigns) {
+            std::string cs;
+            if (chance(3)) {
+                cs = std::to_string(uniform(2620000, 2629999));
+            } else {
+                cs = prefixes[uniform(0, static_cast<int>(std::size(prefixes)) - 1)];
+                if (cs.back() < '0' || cs.back() > '9') cs += static_cast<char>('0' + uniform(0, 9));
+                const int suffix = uniform(2, 3);
+                for (int i = 0; i < suffix; ++i) cs += static_cast<char>('A' + uniform(0, 25));
+            }
+            callsigns_.push_back(std::move(cs));
+        }
+    }
+
+    const std::string& pickCallsign() {
+        const double r = uniformReal(0, zipf_.back());
+        const size_t k = static_cast<size_t>(std::lower_bound(zipf_.begin(), zipf_.end(), r) - zipf_.begin());
+        return callsigns_[std::min(k, callsigns_.size() - 1)];
+    }
+
+    int pickMode() {
+        const double r = uniformReal(0, o_.mix[0] + o_.mix[1] + o_.mix[2]);
+        if (r < o_.mix[0]) return kDStar;
+        if (r < o_.mix[0] + o_.mix[1]) return kYSF;
+        return kDMR;
+    }
+
+    // log-normal mit Median medianDuration, begrenzt auf 0,3 .. 180 s (Timeout von MMDVMHost)
+    int64_t durationMs() {
+        std::lognormal_distribution<double> d(std::log(o_.medianDuration), 0.9);
+        return static_cast<int64_t>(std::clamp(d(rng_), 0.3, 180.0) * 1000.0);
+    }
+
+    [[gnu::format(printf, 1, 2)]]
+    static std::string fmt(const char* f, ...) {
+        char buf[256];
+        va_list ap;
+        va_start(ap, f);
+        std::vsnprintf(buf, sizeof(buf), f, ap);
+        va_end(ap);
+        return buf;
+    }
+
+    void transmission(int mode, int slot, int64_t start, int64_t end) {
+        const std::string& cs = pickCallsign();
+        const bool net = chance(o_.netShare);
+        const double secs = static_cast<double>(end - start) / 1000.0;
+        const double ber = chance(60) ? 0.0 : uniformReal(0, 8);
+        const int loss = net && chance(20) ? uniform(1, 15) : 0;
+        const char* src = net ? "network" : "RF";
+
+        switch (mode) {
+            case kDStar: {
+                const std::string padded = fmt("%-8s/%-4s", cs.c_str(), chance(50) ? "ID51" : "");
+                if (net) push(start, kMMDVM, 'M', fmt("D-Star, received network header from %s to CQCQCQ   via DCS002 C", padded.c_str()));
+                else     push(start, kMMDVM, 'M', fmt("D-Star, received RF header from %s to CQCQCQ  ", padded.c_str()));
+                if (net) push(end, kMMDVM, 'M', fmt("D-Star, received network end of transmission from %s to CQCQCQ  , %.1f seconds, %d%% packet loss, BER: %.1f%%",
+                                                    padded.c_str(), secs, loss, ber));
+                else     push(end, kMMDVM, 'M', fmt("D-Star, received RF end of transmission from %s to CQCQCQ  , %.1f seconds, BER: %.1f%%",
+                                                    padded.c_str(), secs, ber));
+                break;
+            }
+            case kYSF: {
+                const int dg = chance(70) ? 0 : uniform(1, 99);
+                if (net) push(start, kMMDVM, 'M', fmt("YSF, received network data from %-10s to DG-ID %d at FCS00490", cs.c_str(), dg));
+                else     push(start, kMMDVM, 'M', fmt("YSF, received RF header from %-10s to DG-ID %d", cs.c_str(), dg));
+                if (net && chance(10))
+                    push(end, kMMDVM, 'M', fmt("YSF, network watchdog has expired, %.1f seconds, %d%% packet loss, BER: %.1f%%", secs, loss, ber));
+                else if (net)
+                    push(end, kMMDVM, 'M', fmt("YSF, received network end of transmission from %-10s to DG-ID %d, %.1f seconds, %d%% packet loss, BER: %.1f%%",
+                                               cs.c_str(), dg, secs, loss, ber));
+                else
+                    push(end, kMMDVM, 'M', fmt("YSF, received RF end of transmission from %-10s to DG-ID %d, %.1f seconds, BER: %.1f%%",
+                                               cs.c_str(), dg, secs, ber));
+                break;
+            }
+            default: {
+                static const int tgs[] = {9, 91, 262, 2621, 26200, 263, 232, 2322, 4000, 9990};
+                const int tg = tgs[uniform(0, static_cast<int>(std::size(tgs)) - 1)];
+                push(start, kMMDVM, 'M', fmt("DMR Slot %d, received %s voice header from %s to TG %d", slot + 1, src, cs.c_str(), tg));
+                if (net) push(end, kMMDVM, 'M', fmt("DMR Slot %d, received network end of voice transmission from %s to TG %d, %.1f seconds, %d%% packet loss, BER: %.1f%%",
+                                                    slot + 1, cs.c_str(), tg, secs, loss, ber));
+                else     push(end, kMMDVM, 'M', fmt("DMR Slot %d, received RF end of voice transmission from %s to TG %d, %.1f seconds, BER: %.1f%%",
+                                                    slot + 1, cs.c_str(), tg, secs, ber));
+                break;
+            }
+        }
+
+        // irrelevante Zeilen während der Übertragung
+        std::poisson_distribution<int> nNoise(o_.noise);
+        for (int i = nNoise(rng_); i > 0; --i) {
+            const int64_t at = start + static_cast<int64_t>(uniformReal(0, static_cast<double>(end - start)));
+            noise(mode, slot, at);
+        }
+    }
+
+    void noise(int mode, int slot, int64_t at) {
+        switch (uniform(0, 5)) {
+            case 0:
+                push(at, kMMDVM, 'D', mode == kDMR ? fmt("DMR Slot %d, audio sequence no. %d, audio frames lost", slot + 1, uniform(0, 99))
+                                                   : fmt("%s, audio frames lost", kModeNames[mode]));
+                break;
+            case 1:
+                push(at, kMMDVM, 'M', fmt("DMR Talker Alias (Data Format 1, Received %d/24 char): '%s'", uniform(1, 24), pickCallsign().c_str()));
+                break;
+            case 2:
+                push(at, kMMDVM, 'M', fmt("D-Star, network slow data text = \"%s  73\"", pickCallsign().c_str()));
+                break;
+            case 3:
+                push(at, kYSFGateway, 'D', fmt("Sending %d bytes of data to the reflector", uniform(20, 155)));
+                break;
+            case 4:
+                push(at, kDMRGateway, 'D', fmt("DMR, Sending keepalive to network %d", uniform(1, 5)));
+                break;
+            default:
+                push(at, kMMDVM, 'I', fmt("Debug stuff with no relevance at all, counter %d", uniform(0, 99999)));
+                break;
+        }
+    }
+
+    void scheduleLink() {
+        if (o_.linksPerHour <= 0) { nextLink_ = INT64_MAX; return; }
+        std::exponential_distribution<double> gap(o_.linksPerHour / 3600.0);
+        nextLink_ += static_cast<int64_t>(gap(rng_) * 1000.0) + 1;
+    }
+
+    // Reflektor-Wechsel: D-Star im MMDVM-Log, YSF im YSFGateway-Log, DMR-Master im DMRGateway-Log
+    void emitLink(int64_t at) {
+        static const char* const dstar[] = {"DCS002 C", "XRF123 A", "REF001 C", "DCS001 R"};
+        static const char* const ysf[]   = {"DE-C4FM-Germany", "FCS004-90", "AT-C4FM-Austria", "US-America-Link"};
+        static const char* const dmr[]   = {"BM_2621_Germany", "BM_2622_Germany", "TGIF_Network", "XLX950"};
+        switch (uniform(0, 2)) {
+            case 0:
+                push(at, kMMDVM, 'M', fmt("D-Star link status set to \"Verlinkt zu %s\"", dstar[uniform(0, 3)]));
+                break;
+            case 1:
+                if (chance(20)) {
+                    push(at, kYSFGateway, 'M', "Disconnect by remote command");
+                    push(at + 1, kYSFGateway, 'M', "Closing YSF network connection");
+                } else {
+                    push(at, kYSFGateway, 'M', fmt("Linked to %s", ysf[uniform(0, 3)]));
+                }
+                break;
+            default:
+                push(at, kDMRGateway, 'M', fmt("%s, Logged into the master successfully", dmr[uniform(0, 3)]));
+                break;
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) return 2;
+    if (o.out != "-") {
+        std::error_code ec;
+        std::filesystem::create_directories(o.out, ec);
+    }
+
+    const bool live = o.rate > 0;
+    const int64_t startMs = live ? nowMs() : o.startDay.value_or(nowMs() / 86400000) * 86400000;
+    int64_t endMs = INT64_MAX;
+    if (o.hours) endMs = startMs + static_cast<int64_t>(*o.hours * 3600000.0);
+    else if (!live && o.size == 0) endMs = startMs + 24 * 3600000LL;
+
+    TrafficModel model(o, startMs);
+    LogSink sink(o.out);
+
+    // Live: Zeilen im Takt o.rate, Zeitstempel = Zeitpunkt des Schreibens
+    const auto liveStart = std::chrono::steady_clock::now();
+    uint64_t lines = 0;
+    TrafficModel::Line line;
+
+    auto emit = [&](const TrafficModel::Line& l) {
+        if (live) {
+            const auto due = liveStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                 std::chrono::duration<double>(static_cast<double>(lines) / o.rate));
+            if (due > std::chrono::steady_clock::now() + std::chrono::milliseconds(1)) {
+                sink.flush();
+                std::this_thread::sleep_until(due);
+            }
+        }
+        if (!sink.write(l.stream, live ? nowMs() : l.ms, l.level, l.text)) return false;
+        ++lines;
+        return true;
+    };
+
+    bool ok = true;
+    while (ok && model.now() < endMs && (o.size == 0 || sink.bytes() < o.size)) {
+        model.step();
+        while (ok && model.pop(std::min(model.safeMs(), endMs), line)) ok = emit(line);
+    }
+    // Rest (Enden der letzten Übertragungen) nur im Zeitfenster
+    while (ok && (o.size == 0 || sink.bytes() < o.size) && model.pop(endMs, line)) ok = emit(line);
+    sink.flush();
+
+    std::cerr << "[GEN ] lines=" << lines << " bytes=" << sink.bytes() << "\n";
+    return ok ? 0 : 1;
+}
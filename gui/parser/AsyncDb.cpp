@@ -0,0 +1,293 @@
+// AsyncDb.cpp
+#include "AsyncDb.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <mysql/errmsg.h>
+
+AsyncDb::AsyncDb(EventLoop& loop, const std::string& unixSocket)
+    : loop_(loop), unixSocket_(unixSocket)
+{
+    timer_ = loop_.addTimer([this] { onTimer(); });
+}
+
+AsyncDb::~AsyncDb()
+{
+    disconnect(nullptr);
+    loop_.removeTimer(timer_);
+}
+
+std::string AsyncDb::escape(const std::string& in)
+{
+    std::string out;
+    out.resize(in.size() * 2 + 1);
+    unsigned long n = mysql_escape_string(&out[0], in.c_str(), static_cast<unsigned long>(in.size()));
+    out.resize(n);
+    return out;
+}
+
+void AsyncDb::query(std::string sql, Done done)
+{
+    if (ops_.size() >= kMaxPending) {
+        // Server dauerhaft weg: lieber alte Statements verlieren als unbegrenzt Speicher
+        Op old = std::move(ops_.front());
+        ops_.pop_front();
+        std::fprintf(stderr, "[ADB] queue full, dropping: %.60s\n", old.sql.c_str());
+        if (old.done) old.done(nullptr, "queue full");
+    }
+    ops_.push_back(Op{std::move(sql), std::move(done), false});
+    kick();
+}
+
+// Nächsten Schritt anstoßen, wenn die Verbindung gerade nichts zu tun hat
+void AsyncDb::kick()
+{
+    if (ops_.empty()) return;
+    if (state_ == State::Idle) {
+        startQuery();
+    } else if (state_ == State::Down) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= retryAt_) startConnect();
+        else loop_.armTimer(timer_, static_cast<unsigned>(
+                 std::chrono::duration_cast<std::chrono::milliseconds>(retryAt_ - now).count()) + 1);
+    }
+}
+
+void AsyncDb::startConnect()
+{
+    conn_ = mysql_init(nullptr);
+    if (!conn_) {
+        std::fprintf(stderr, "[ADB] mysql_init failed\n");
+        retryLater();
+        return;
+    }
+    mysql_options(conn_, MYSQL_OPT_NONBLOCK, nullptr);
+    unsigned int proto = MYSQL_PROTOCOL_SOCKET;
+    mysql_options(conn_, MYSQL_OPT_PROTOCOL, &proto);
+
+    state_ = State::Connecting;
+    int status = mysql_real_connect_start(&connRet_, conn_, nullptr, dbUser_.c_str(), dbPass_.c_str(),
+                                          dbName_.c_str(), 0, unixSocket_.c_str(), 0);
+    step(status, true);
+}
+
+void AsyncDb::startQuery()
+{
+    state_ = State::Query;
+    const std::string& sql = ops_.front().sql;
+    int status = mysql_real_query_start(&queryErr_, conn_, sql.c_str(), static_cast<unsigned long>(sql.size()));
+    step(status, true);
+}
+
+void AsyncDb::startStore()
+{
+    state_ = State::Store;
+    int status = mysql_store_result_start(&storeRes_, conn_);
+    step(status, true);
+}
+
+void AsyncDb::retryLater()
+{
+    retryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(retryMs_);
+    retryMs_ = std::min(retryMs_ * 2, kRetryMaxMs);
+    kick();
+}
+
+void AsyncDb::onFd(uint32_t events)
+{
+    if (state_ == State::Idle) {
+        // Ohne laufendes Statement meldet sich der Socket nur, wenn der Server die Verbindung schließt
+        disconnect("connection closed by server");
+        kick();
+        return;
+    }
+    int status = 0;
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) status |= MYSQL_WAIT_READ;
+    if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) status |= MYSQL_WAIT_WRITE;
+    if (events & EPOLLPRI) status |= MYSQL_WAIT_EXCEPT;
+    step(status, false);
+}
+
+void AsyncDb::onTimer()
+{
+    if (state_ == State::Down) kick();         // Wartezeit fürs Wiederverbinden abgelaufen
+    else if (state_ != State::Idle) step(MYSQL_WAIT_TIMEOUT, false);
+}
+
+// Eine Operation fortsetzen. started: status kommt direkt von _start, sonst sind es die
+// eingetretenen Wartebedingungen für _cont. Solange status != 0 ist, wartet die Operation weiter.
+void AsyncDb::step(int status, bool started)
+{
+    switch (state_) {
+    case State::Connecting:
+        if (!started) status = mysql_real_connect_cont(&connRet_, conn_, status);
+        if (status) { wait(status); return; }
+        if (!connRet_) {
+            ++c_.connectFailures;
+            std::fprintf(stderr, "[ADB] connect failed: %s (retry in %u ms)\n", mysql_error(conn_), retryMs_);
+            disconnect(nullptr);
+            retryLater();
+            return;
+        }
+        if (everConnected_) {
+            ++c_.reconnects;
+            std::fprintf(stderr, "[ADB] reconnected via unix_socket=%s (%s)\n", unixSocket_.c_str(), countersText().c_str());
+        }
+        everConnected_ = true;
+        retryMs_ = kRetryMinMs;
+        state_ = State::Idle;
+        wait(0);
+        kick();
+        return;
+
+    case State::Query:
+        if (!started) status = mysql_real_query_cont(&queryErr_, conn_, status);
+        if (status) { wait(status); return; }
+        if (queryErr_) {
+            const unsigned code = mysql_errno(conn_);
+            const std::string error = mysql_error(conn_);
+            if (DbConn::isConnectionLost(code)) {
+                Op& op = ops_.front();
+                if (!op.retried && DbConn::retrySafe(code)) {
+                    // Statement bleibt vorn in der Schlange und läuft nach dem Neuaufbau sofort noch einmal
+                    std::fprintf(stderr, "[ADB] connection lost (%u %s) -> reconnect and retry\n", code, error.c_str());
+                    op.retried = true;
+                    ++c_.retries;
+                    disconnect(nullptr);
+                    retryMs_ = kRetryMinMs;
+                    retryAt_ = std::chrono::steady_clock::now();
+                    kick();
+                    return;
+                }
+                // Verbindung zuerst abbauen, damit Statements aus dem Callback erst nach dem Neuaufbau laufen
+                disconnect(op.retried ? "connection lost again, giving up on statement"
+                                      : "connection lost during statement, not retried (may have run)");
+            }
+            complete(nullptr, error.c_str());
+            kick();
+            return;
+        }
+        if (mysql_field_count(conn_) > 0) { startStore(); return; }
+        complete(nullptr, nullptr);
+        kick();
+        return;
+
+    case State::Store:
+        if (!started) status = mysql_store_result_cont(&storeRes_, conn_, status);
+        if (status) { wait(status); return; }
+        if (MYSQL_RES* res = storeRes_) {
+            storeRes_ = nullptr;
+            complete(res, nullptr);
+            mysql_free_result(res);
+        } else {
+            complete(nullptr, mysql_error(conn_));
+        }
+        kick();
+        return;
+
+    case State::Down:
+    case State::Idle:
+        return;
+    }
+}
+
+// Auf das warten, was _start/_cont verlangt; status == 0: nur noch auf Verbindungsende achten
+void AsyncDb::wait(int status)
+{
+    uint32_t events = 0;
+    if (status & MYSQL_WAIT_READ) events |= EPOLLIN;
+    if (status & MYSQL_WAIT_WRITE) events |= EPOLLOUT;
+    if (status & MYSQL_WAIT_EXCEPT) events |= EPOLLPRI;
+    if (status == 0) events = EPOLLRDHUP;
+
+    const int fd = mysql_get_socket(conn_);
+    if (fd != fd_) {
+        if (fd_ >= 0) loop_.remove(fd_);
+        fd_ = fd;
+        if (fd_ >= 0) loop_.add(fd_, events, [this](uint32_t ev) { onFd(ev); });
+    } else if (fd_ >= 0) {
+        loop_.modify(fd_, events);
+    }
+
+    if (status & MYSQL_WAIT_TIMEOUT) loop_.armTimer(timer_, std::max(1u, mysql_get_timeout_value_ms(conn_)));
+    else loop_.armTimer(timer_, 0);
+}
+
+// Laufendes Statement beenden; der Callback darf neue Statements einreihen
+void AsyncDb::complete(MYSQL_RES* res, const char* error)
+{
+    Op op = std::move(ops_.front());
+    ops_.pop_front();
+    if (state_ != State::Down) {
+        state_ = State::Idle;
+        wait(0);
+    }
+    if (error) std::fprintf(stderr, "[ADB] query failed: %s (%.60s)\n", error, op.sql.c_str());
+    if (op.done) op.done(res, error);
+}
+
+void AsyncDb::disconnect(const char* why)
+{
+    if (why) std::fprintf(stderr, "[ADB] %s\n", why);
+    if (fd_ >= 0) { loop_.remove(fd_); fd_ = -1; }
+    if (conn_) { mysql_close(conn_); conn_ = nullptr; }
+    if (timer_ >= 0) loop_.armTimer(timer_, 0);
+    state_ = State::Down;
+}
+
+// ---- AsyncDbPool ----
+
+AsyncDbPool::AsyncDbPool(EventLoop& loop, size_t connections, const std::string& unixSocket)
+    : loop_(loop)
+{
+    for (size_t i = 0; i < std::max<size_t>(1, connections); ++i)
+        conns_.push_back(std::make_unique<AsyncDb>(loop_, unixSocket));
+
+    wakefd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakefd_ < 0) std::fprintf(stderr, "[ADB] eventfd failed: %s\n", std::strerror(errno));
+    else loop_.add(wakefd_, EPOLLIN, [this](uint32_t) { onWake(); });
+}
+
+AsyncDbPool::~AsyncDbPool()
+{
+    if (wakefd_ >= 0) {
+        loop_.remove(wakefd_);
+        ::close(wakefd_);
+    }
+}
+
+void AsyncDbPool::query(unsigned key, std::string sql, AsyncDb::Done done)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        inbox_.push_back(Item{key, std::move(sql), std::move(done)});
+    }
+    uint64_t one = 1;
+    ssize_t n = ::write(wakefd_, &one, sizeof(one));
+    (void)n;
+}
+
+std::string AsyncDbPool::countersText(unsigned key) const
+{
+    return conns_[key % conns_.size()]->countersText();
+}
+
+void AsyncDbPool::onWake()
+{
+    uint64_t cnt;
+    ssize_t n = ::read(wakefd_, &cnt, sizeof(cnt));
+    (void)n;
+
+    std::vector<Item> items;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        items.swap(inbox_);
+    }
+    for (auto& it : items)
+        conns_[it.key % conns_.size()]->query(std::move(it.sql), std::move(it.done));
+}
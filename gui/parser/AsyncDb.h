@@ -0,0 +1,125 @@
+// AsyncDb.h
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <mysql/mysql.h>
+
+#include "EventLoop.h"
+#include "../DbConn.h"
+
+/**
+ * Nicht blockierende MariaDB-Verbindung über die Connector/C-Funktionen mysql_*_start / _cont.
+ * Statements werden der Reihe nach abgearbeitet; während der Server rechnet, läuft die
+ * EventLoop weiter. Nur aus dem Thread der EventLoop benutzen (von außen: AsyncDbPool).
+ * Verbindungsverlust wie bei DbConn: neu verbinden und das Statement genau einmal wiederholen,
+ * aber nur bei CR_SERVER_GONE_ERROR (nach CR_SERVER_LOST ist offen, ob es schon gelaufen ist).
+ */
+class AsyncDb {
+public:
+    // res nur bei Statements mit Ergebnis (wird danach freigegeben), error == nullptr bei Erfolg
+    using Done = std::function<void(MYSQL_RES* res, const char* error)>;
+
+    AsyncDb(EventLoop& loop, const std::string& unixSocket);
+    ~AsyncDb();
+
+    AsyncDb(const AsyncDb&) = delete;
+    AsyncDb& operator=(const AsyncDb&) = delete;
+
+    void query(std::string sql, Done done);
+
+    size_t pending() const noexcept { return ops_.size(); }
+
+    // dieselben Zähler wie DbConn; pings bleibt 0: ein Schließen durch den Server
+    // meldet der Socket in der EventLoop (EPOLLRDHUP), dafür braucht es keinen Ping
+    const DbConn::Counters& counters() const noexcept { return c_; }
+    std::string countersText() const { return DbConn::countersText(c_); }
+
+    // Escaping ohne Verbindung (utf8mb4 ist dafür unkritisch)
+    static std::string escape(const std::string& in);
+
+private:
+    enum class State { Down, Connecting, Idle, Query, Store };
+    struct Op {
+        std::string sql;
+        Done done;
+        bool retried = false;       // nach CR_SERVER_GONE_ERROR schon einmal wiederholt
+    };
+
+    static constexpr size_t kMaxPending = 1000;      // darüber wird das älteste Statement verworfen
+    static constexpr unsigned kRetryMinMs = 1000;
+    static constexpr unsigned kRetryMaxMs = 30000;
+
+    void kick();
+    void startConnect();
+    void startQuery();
+    void startStore();
+    void onFd(uint32_t events);
+    void onTimer();
+    void retryLater();
+    void step(int status, bool started);
+    void wait(int status);
+    void complete(MYSQL_RES* res, const char* error);
+    void disconnect(const char* why);
+
+    EventLoop& loop_;
+    const std::string unixSocket_;
+
+    MYSQL* conn_ = nullptr;
+    int fd_ = -1;                   // Socket der Verbindung, in der EventLoop registriert
+    int timer_ = -1;                // MYSQL_WAIT_TIMEOUT und Wiederverbinden
+    State state_ = State::Down;
+    std::deque<Op> ops_;
+    MYSQL* connRet_ = nullptr;      // Ergebnisse von _start/_cont
+    int queryErr_ = 0;
+    MYSQL_RES* storeRes_ = nullptr;
+    unsigned retryMs_ = kRetryMinMs;
+    std::chrono::steady_clock::time_point retryAt_{};
+    bool everConnected_ = false;
+    DbConn::Counters c_;
+
+    const std::string dbUser_ = "mmdvm";
+    const std::string dbPass_ = "";
+    const std::string dbName_ = "mmdvmdb";
+};
+
+/**
+ * Mehrere AsyncDb-Verbindungen an einer EventLoop. query() ist aus jedem Thread erlaubt;
+ * die Callbacks laufen im Thread der EventLoop. Statements mit demselben key landen auf
+ * derselben Verbindung und behalten damit ihre Reihenfolge; verschiedene keys laufen parallel.
+ */
+class AsyncDbPool {
+public:
+    AsyncDbPool(EventLoop& loop, size_t connections,
+                const std::string& unixSocket = "/run/mysqld/mysqld.sock");
+    ~AsyncDbPool();
+
+    AsyncDbPool(const AsyncDbPool&) = delete;
+    AsyncDbPool& operator=(const AsyncDbPool&) = delete;
+
+    void query(unsigned key, std::string sql, AsyncDb::Done done = {});
+
+    // Zähler der Verbindung für key; nur im Thread der EventLoop bzw. nach deren Ende
+    std::string countersText(unsigned key) const;
+
+private:
+    struct Item {
+        unsigned key;
+        std::string sql;
+        AsyncDb::Done done;
+    };
+
+    void onWake();
+
+    EventLoop& loop_;
+    std::vector<std::unique_ptr<AsyncDb>> conns_;
+    int wakefd_ = -1;
+
+    std::mutex mtx_;
+    std::vector<Item> inbox_;
+};
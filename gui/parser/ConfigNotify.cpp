@@ -0,0 +1,62 @@
+// ConfigNotify.cpp
+#include "ConfigNotify.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ConfigNotify::ConfigNotify(EventLoop& loop, std::function<void()> onNotify, std::string path)
+    : loop_(loop), onNotify_(std::move(onNotify)), path_(std::move(path))
+{
+    sockaddr_un addr{};
+    if (path_.size() >= sizeof(addr.sun_path)) {
+        std::fprintf(stderr, "[NOTIFY] path too long: %s\n", path_.c_str());
+        return;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path_.c_str(), path_.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::fprintf(stderr, "[NOTIFY] socket failed: %s\n", std::strerror(errno));
+        return;
+    }
+    ::unlink(path_.c_str()); // Rest eines abgestürzten Laufs
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::fprintf(stderr, "[NOTIFY] bind %s failed: %s\n", path_.c_str(), std::strerror(errno));
+        ::close(fd);
+        return;
+    }
+    // PHP läuft als www-data: senden darf jeder lokale Prozess, mehr als "lies neu" geht damit nicht
+    ::chmod(path_.c_str(), 0666);
+
+    if (!loop_.add(fd, EPOLLIN, [this](uint32_t) { onReadable(); })) {
+        ::close(fd);
+        ::unlink(path_.c_str());
+        return;
+    }
+    fd_ = fd;
+    std::fprintf(stderr, "[NOTIFY] listening on %s\n", path_.c_str());
+}
+
+ConfigNotify::~ConfigNotify()
+{
+    if (fd_ < 0) return;
+    loop_.remove(fd_);
+    ::close(fd_);
+    ::unlink(path_.c_str());
+}
+
+void ConfigNotify::onReadable() noexcept
+{
+    // alle anstehenden Datagramme verwerfen: ein Aufruf genügt für beliebig viele Speichervorgänge
+    char buf[64];
+    unsigned n = 0;
+    while (::recv(fd_, buf, sizeof(buf), 0) >= 0) ++n;
+    if (n && onNotify_) onNotify_();
+}
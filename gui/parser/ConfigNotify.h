@@ -0,0 +1,37 @@
+// ConfigNotify.h
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "EventLoop.h"
+
+/**
+ * Weckruf der Web-GUI: save_config.php schickt nach dem Schreiben von config_inbox ein
+ * Datagramm an einen Unix-Socket, DVconfig liest config_inbox erst dann.
+ * Der Inhalt ist egal; mehrere Datagramme bis zum nächsten Durchlauf der EventLoop
+ * ergeben einen Aufruf von onNotify.
+ */
+class ConfigNotify {
+public:
+    // gleicher Pfad wie in html/save_config.php; Verzeichnis legt systemd an (RuntimeDirectory)
+    static constexpr const char* kDefaultPath = "/run/mmdvm-dvconfig/notify.sock";
+
+    ConfigNotify(EventLoop& loop, std::function<void()> onNotify, std::string path = kDefaultPath);
+    ~ConfigNotify();
+
+    ConfigNotify(const ConfigNotify&) = delete;
+    ConfigNotify& operator=(const ConfigNotify&) = delete;
+
+    // false: Socket nicht gebunden (z.B. Verzeichnis fehlt) – dann bleibt nur das Abfragen
+    bool ok() const noexcept { return fd_ >= 0; }
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    void onReadable() noexcept;
+
+    EventLoop& loop_;
+    std::function<void()> onNotify_;
+    std::string path_;
+    int fd_ = -1;
+};
@@ -7,12 +7,15 @@
 
 // Close on destruction
 Database::~Database() {
-    if (conn_) { mysql_close(conn_); conn_ = nullptr; }
+    db_.close();
 }
 
 // Connect at construction
 Database::Database() {
-    if (!connect()) {
+    db_.onConnect([this](MYSQL* c) { return onConnect(c); });
+    db_.onClose([this] { conn_ = nullptr; });
+    if (!db_.get()) {
+        last_error_ = db_.lastError();
         std::fprintf(stderr, "[DB] initial connect() failed: %s\n", last_error_.c_str());
     }
 }
@@ -30,50 +33,17 @@ bool Database::exec(const char* sql) noexcept {
     return false;
 }
 
-// Ensure connection is alive
+// Ensure connection is up
 bool Database::ensure_conn() noexcept {
-    if (!conn_) {
-        bool ok = connect();
-        if (!ok) std::fprintf(stderr, "[DB] ensure_conn: connect failed: %s\n", last_error_.c_str());
-        return ok;
-    }
-    if (mysql_ping(conn_) == 0) return true;
-    std::fprintf(stderr, "[DB] ping failed: %s -> reconnect\n", mysql_error(conn_));
-    bool ok = connect();
-    if (!ok) std::fprintf(stderr, "[DB] reconnect failed: %s\n", last_error_.c_str());
-    return ok;
+    if (db_.get()) return true;
+    last_error_ = db_.lastError();
+    return false;
 }
 
-// Open socket connection and ensure schema
-bool Database::connect() noexcept {
+// Runs after every (re)connect from DbConn: ensure schema and the single row
+bool Database::onConnect(MYSQL* c) noexcept {
     last_error_.clear();
-    if (conn_) { mysql_close(conn_); conn_ = nullptr; }
-
-    conn_ = mysql_init(nullptr);
-    if (!conn_) {
-        last_error_ = "mysql_init failed";
-        std::fprintf(stderr, "[DB] %s\n", last_error_.c_str());
-        return false;
-    }
-
-    // optional auto-reconnect (use bool for modern headers)
-    {
-        bool rc = true;
-        mysql_options(conn_, MYSQL_OPT_RECONNECT, &rc);
-    }
-    // force Unix-socket protocol
-    {
-        unsigned int proto = MYSQL_PROTOCOL_SOCKET;
-        mysql_options(conn_, MYSQL_OPT_PROTOCOL, &proto);
-    }
-
-    if (!mysql_real_connect(conn_, /*host*/nullptr, user_.c_str(), /*pass*/"",
-                            name_.c_str(), port_, unix_socket_.c_str(), /*flags*/0)) {
-        last_error_ = mysql_error(conn_);
-        std::fprintf(stderr, "[DB] mysql_real_connect failed: %s\n", last_error_.c_str());
-        mysql_close(conn_); conn_ = nullptr;
-        return false;
-    }
+    conn_ = c;
 
     if (!createTableIfNeeded()) {
         std::fprintf(stderr, "[DB] createTableIfNeeded failed: %s\n", last_error_.c_str());
@@ -206,61 +176,44 @@ bool Database::writeSiteData(const siteData& s) noexcept {
     q += "is_new='BACKEND' ";
     q += "WHERE id=1";
 
-    if (!exec(q.c_str())) {
+    // q stays valid across a reconnect (same charset), so DbConn may simply retry it
+    if (db_.run([&](MYSQL*) { return exec(q.c_str()); }) != DbConn::Result::Ok) {
         std::fprintf(stderr, "[DB] writeSiteData UPDATE failed: %s\n", last_error_.c_str());
         return false;
     }
     return true;
 }
 
-bool Database::readSiteData(siteData& s) noexcept {
-    if (!ensure_conn()) {
-        std::fprintf(stderr, "[DB] readSiteData: no connection: %s\n", last_error_.c_str());
-        return false;
-    }
-
-    static const char* q =
-        "SELECT "
-        " callsign,"          // 0
-        " module,"            // 1
-        " dmr_id,"            // 2
-        " duplex,"            // 3
-        " rxfreq,"            // 4
-        " txfreq,"            // 5
-        " latitude,"          // 6
-        " longitude,"         // 7
-        " height,"            // 8
-        " location,"          // 9
-        " description,"       // 10
-        " url,"               // 11
-        " reflector1,"        // 12
-        " ysf_suffix,"        // 13
-        " ysf_startup,"       // 14
-        " ysf_options,"       // 15
-        " dmr_address,"       // 16
-        " dmr_password,"      // 17
-        " dmr_name,"          // 18
-        " is_new"             // 19
-        " FROM config_inbox WHERE id=1 LIMIT 1";
-
-    if (mysql_query(conn_, q) != 0) {
-        last_error_ = mysql_error(conn_);
-        std::fprintf(stderr, "[DB] readSiteData query failed: %s\n", last_error_.c_str());
-        return false;
-    }
+const char* const Database::kSelectSiteData =
+    "SELECT "
+    " callsign,"          // 0
+    " module,"            // 1
+    " dmr_id,"            // 2
+    " duplex,"            // 3
+    " rxfreq,"            // 4
+    " txfreq,"            // 5
+    " latitude,"          // 6
+    " longitude,"         // 7
+    " height,"            // 8
+    " location,"          // 9
+    " description,"       // 10
+    " url,"               // 11
+    " reflector1,"        // 12
+    " ysf_suffix,"        // 13
+    " ysf_startup,"       // 14
+    " ysf_options,"       // 15
+    " dmr_address,"       // 16
+    " dmr_password,"      // 17
+    " dmr_name,"          // 18
+    " is_new"             // 19
+    " FROM config_inbox WHERE id=1 LIMIT 1";
 
-    MYSQL_RES* res = mysql_store_result(conn_);
-    if (!res) {
-        last_error_ = mysql_error(conn_);
-        std::fprintf(stderr, "[DB] readSiteData store_result failed: %s\n", last_error_.c_str());
-        return false;
-    }
+const char* const Database::kSetIdle = "UPDATE config_inbox SET is_new='IDLE' WHERE id=1";
 
+bool Database::parseSiteData(MYSQL_RES* res, siteData& s) noexcept {
     MYSQL_ROW row = mysql_fetch_row(res);
     if (!row) {
-        mysql_free_result(res);
-        last_error_ = "readSiteData: no row with id=1";
-        std::fprintf(stderr, "[DB] %s\n", last_error_.c_str());
+        std::fprintf(stderr, "[DB] readSiteData: no row with id=1\n");
         return false;
     }
 
@@ -272,9 +225,6 @@ bool Database::readSiteData(siteData& s) noexcept {
     // Check: is_new muss "GUI" enthalten
     const std::string is_new = get(19);
     if (is_new.find("GUI") == std::string::npos) {
-        mysql_free_result(res);
-        //last_error_ = "readSiteData: is_new != GUI (current: '" + is_new + "')";
-        //std::fprintf(stderr, "[DB] %s\n", last_error_.c_str());
         return false;
     }
 
@@ -298,15 +248,40 @@ bool Database::readSiteData(siteData& s) noexcept {
     s.Address      = get(16);
     s.Password     = get(17);
     s.Name         = get(18);
+    return true;
+}
 
-    // Result vor dem nächsten Query freigeben
-    mysql_free_result(res);
+bool Database::readSiteData(siteData& s) noexcept {
+    bool isNew = false;
+    const DbConn::Result r = db_.run([&](MYSQL* c) {
+        if (mysql_query(c, kSelectSiteData) != 0) {
+            last_error_ = mysql_error(c);
+            std::fprintf(stderr, "[DB] readSiteData query failed: %s\n", last_error_.c_str());
+            return false;
+        }
 
-    // Status auf IDLE setzen (Pflicht — sonst false)
-    if (!exec("UPDATE config_inbox SET is_new='IDLE' WHERE id=1")) {
-        std::fprintf(stderr, "[DB] readSiteData: set is_new=IDLE failed: %s\n", last_error_.c_str());
-        return false;
-    }
+        MYSQL_RES* res = mysql_store_result(c);
+        if (!res) {
+            last_error_ = mysql_error(c);
+            std::fprintf(stderr, "[DB] readSiteData store_result failed: %s\n", last_error_.c_str());
+            return false;
+        }
 
-    return true;
+        isNew = parseSiteData(res, s);
+        // Result vor dem nächsten Query freigeben
+        mysql_free_result(res);
+        if (!isNew) return true;
+
+        // Status auf IDLE setzen (Pflicht — sonst false)
+        if (!exec(kSetIdle)) {
+            std::fprintf(stderr, "[DB] readSiteData: set is_new=IDLE failed: %s\n", last_error_.c_str());
+            return false;
+        }
+        return true;
+    });
+    if (r == DbConn::Result::Down) {
+        if (last_error_.empty()) last_error_ = db_.lastError();
+        std::fprintf(stderr, "[DB] readSiteData: no connection: %s\n", last_error_.c_str());
+    }
+    return r == DbConn::Result::Ok && isNew;
 }
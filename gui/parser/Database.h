@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <mysql/mysql.h>
+#include "../DbConn.h"
 
 struct siteData; // forward declaration
 
@@ -13,7 +14,7 @@ public:
     Database();
     ~Database();
 
-    // Ensure connection is alive (reconnects if needed)
+    // Ensure connection is up (reconnects if needed; pings only after idle, see DbConn)
     bool ensure_conn() noexcept;
 
     // Write site data (id=1 row) into config_inbox
@@ -22,23 +23,26 @@ public:
     // Read site data (id=1) aus config_inbox in s
     bool readSiteData(struct siteData& s) noexcept;
 
+    // Für den asynchronen Weg (AsyncDb): dieselbe Abfrage, Auswertung und Quittung wie readSiteData
+    static const char* const kSelectSiteData;
+    static const char* const kSetIdle;
+    // true, wenn is_new "GUI" enthält; nur dann wird s befüllt
+    static bool parseSiteData(MYSQL_RES* res, struct siteData& s) noexcept;
+
     // Last error text (empty if none)
     const std::string& lastError() const noexcept { return last_error_; }
 
+    // Pings, reconnects, retries
+    const DbConn& dbConn() const noexcept { return db_; }
+
 private:
-    bool connect() noexcept;
+    bool onConnect(MYSQL* c) noexcept;
     bool exec(const char* sql) noexcept;
     bool createTableIfNeeded() noexcept;
     bool ensureSingleRow() noexcept;
 
 private:
-    std::string host_        = "localhost";
-    std::string user_        = "mmdvm";
-    std::string pass_        = "";
-    std::string name_        = "mmdvmdb";
-    unsigned int port_       = 0;
-    std::string unix_socket_ = "/run/mysqld/mysqld.sock";
-
-    MYSQL* conn_ = nullptr;
+    DbConn db_{DbConn::Settings{}};
+    MYSQL* conn_ = nullptr;     // current connection, valid between onConnect and close
     std::string last_error_;
 };
\ No newline at end of file
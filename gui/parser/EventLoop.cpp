@@ -0,0 +1,140 @@
+// EventLoop.cpp
+#include "EventLoop.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+EventLoop::EventLoop()
+{
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd_ < 0) std::fprintf(stderr, "[LOOP] epoll_create1 failed: %s\n", std::strerror(errno));
+
+    stopfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stopfd_ < 0) std::fprintf(stderr, "[LOOP] eventfd failed: %s\n", std::strerror(errno));
+    else add(stopfd_, EPOLLIN, [this](uint32_t) {
+        uint64_t cnt;
+        ssize_t n = ::read(stopfd_, &cnt, sizeof(cnt));
+        (void)n;
+        running_ = false;
+    });
+}
+
+EventLoop::~EventLoop()
+{
+    for (int tfd : timers_) ::close(tfd); // Timer gehören der Schleife, alle anderen fds dem Aufrufer
+    handlers_.clear();
+    if (stopfd_ >= 0) ::close(stopfd_);
+    if (epfd_ >= 0) ::close(epfd_);
+}
+
+bool EventLoop::add(int fd, uint32_t events, Handler h) noexcept
+{
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        std::fprintf(stderr, "[LOOP] epoll add fd %d failed: %s\n", fd, std::strerror(errno));
+        return false;
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(h));
+    return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) noexcept
+{
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) != 0) {
+        std::fprintf(stderr, "[LOOP] epoll mod fd %d failed: %s\n", fd, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::remove(int fd) noexcept
+{
+    if (handlers_.erase(fd) == 0) return;
+    epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EventLoop::addTimer(std::function<void()> cb) noexcept
+{
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (tfd < 0) {
+        std::fprintf(stderr, "[LOOP] timerfd_create failed: %s\n", std::strerror(errno));
+        return -1;
+    }
+    auto fire = [tfd, cb = std::move(cb)](uint32_t) {
+        uint64_t expirations;
+        if (::read(tfd, &expirations, sizeof(expirations)) != sizeof(expirations)) return; // schon entschärft
+        cb();
+    };
+    if (!add(tfd, EPOLLIN, std::move(fire))) {
+        ::close(tfd);
+        return -1;
+    }
+    timers_.insert(tfd);
+    return tfd;
+}
+
+bool EventLoop::armTimer(int tfd, unsigned firstMs, unsigned periodMs) noexcept
+{
+    itimerspec its{};
+    its.it_value.tv_sec = firstMs / 1000;
+    its.it_value.tv_nsec = static_cast<long>(firstMs % 1000) * 1000000L;
+    its.it_interval.tv_sec = periodMs / 1000;
+    its.it_interval.tv_nsec = static_cast<long>(periodMs % 1000) * 1000000L;
+    if (timerfd_settime(tfd, 0, &its, nullptr) != 0) {
+        std::fprintf(stderr, "[LOOP] timerfd_settime failed: %s\n", std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::removeTimer(int tfd) noexcept
+{
+    if (timers_.erase(tfd) == 0) return;
+    remove(tfd);
+    ::close(tfd);
+}
+
+void EventLoop::run()
+{
+    running_ = true;
+    epoll_event events[32];
+    while (running_) {
+        int n = epoll_wait(epfd_, events, 32, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::fprintf(stderr, "[LOOP] epoll_wait failed: %s\n", std::strerror(errno));
+            break;
+        }
+        ++wakeups_;
+        for (int i = 0; i < n; ++i) {
+            auto it = handlers_.find(events[i].data.fd);
+            if (it == handlers_.end()) continue; // in diesem Durchlauf bereits entfernt
+            std::shared_ptr<Handler> h = it->second;
+            (*h)(events[i].events);
+        }
+    }
+    // ein stop() aus einem Handler hat das eventfd noch gesetzt – für das nächste run() leeren
+    uint64_t cnt;
+    ssize_t n = ::read(stopfd_, &cnt, sizeof(cnt));
+    (void)n;
+}
+
+void EventLoop::stop() noexcept
+{
+    running_ = false;
+    if (stopfd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t n = ::write(stopfd_, &one, sizeof(one));
+        (void)n;
+    }
+}
@@ -0,0 +1,53 @@
+// EventLoop.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * Minimaler epoll-Reaktor: Dateideskriptoren und Timer (timerfd) mit Callbacks.
+ * Alle Methoden nur aus dem Thread aufrufen, der run() ausführt – ausgenommen stop(),
+ * das auch aus einem Signal-Handler oder einem anderen Thread heraus funktioniert.
+ */
+class EventLoop {
+public:
+    using Handler = std::function<void(uint32_t events)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // fd mit EPOLLIN/EPOLLOUT/... beobachten; EPOLLHUP/EPOLLERR kommen immer
+    bool add(int fd, uint32_t events, Handler h) noexcept;
+    bool modify(int fd, uint32_t events) noexcept;
+    void remove(int fd) noexcept;
+
+    // Timer anlegen (zunächst nicht scharf); Rückgabe: timerfd, -1 bei Fehler
+    int addTimer(std::function<void()> cb) noexcept;
+    // firstMs = 0 entschärft, periodMs = 0 bedeutet einmalig
+    bool armTimer(int tfd, unsigned firstMs, unsigned periodMs = 0) noexcept;
+    void removeTimer(int tfd) noexcept;
+
+    // Läuft, bis stop() aufgerufen wird
+    void run();
+    void stop() noexcept;
+
+    // Anzahl der Rückkehrer aus epoll_wait (Aufwachvorgänge)
+    uint64_t wakeups() const noexcept { return wakeups_; }
+
+private:
+    int epfd_ = -1;
+    int stopfd_ = -1;
+    std::atomic<bool> running_{false};
+    uint64_t wakeups_ = 0;
+
+    // shared_ptr: ein Handler darf sich im eigenen Callback entfernen
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+    std::unordered_set<int> timers_;
+};
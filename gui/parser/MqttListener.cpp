@@ -1,11 +1,15 @@
 // MqttListener.cpp
 #include "MqttListener.h"
 #include "fmdatabase.h"
+#include "EventLoop.h"
+#include "AsyncDb.h"
 
 #include <iostream>
 #include <cstring>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <sys/epoll.h>
 
 // JSON (nlohmann)
 #include <nlohmann/json.hpp>
@@ -58,6 +62,14 @@ void MqttListener::stop()
 
     s_running = false;
 
+    if (s_loop) {
+        if (s_fd >= 0) s_loop->remove(s_fd);
+        s_loop->removeTimer(s_miscTimer);
+        s_loop->removeTimer(s_reconnectTimer);
+        s_fd = s_miscTimer = s_reconnectTimer = -1;
+        s_loop = nullptr;
+    }
+
     if (s_mosq) {
         mosquitto_disconnect(s_mosq);
     }
@@ -74,12 +86,112 @@ void MqttListener::stop()
     mosquitto_lib_cleanup();
 
     // DB freigeben
+    if (s_pool) std::cerr << "[MqttListener] db " << s_pool->countersText(s_poolKey) << "\n";
+    else if (s_db) std::cerr << "[MqttListener] db " << s_db->countersText() << "\n";
     delete s_db;
     s_db = nullptr;
 
     s_initialized = false;
 }
 
+void MqttListener::setAsyncDb(AsyncDbPool* pool, unsigned key)
+{
+    s_pool = pool;
+    s_poolKey = key;
+    // Schema steht, geschrieben wird über den Pool: eigene Verbindung nicht offen halten
+    if (s_pool && s_db) s_db->release();
+}
+
+void MqttListener::attach(EventLoop& loop)
+{
+    if (!s_initialized.load()) {
+        std::cerr << "[MqttListener] Not initialized\n";
+        return;
+    }
+    if (s_running.load()) {
+        std::cerr << "[MqttListener] Already running\n";
+        return;
+    }
+
+    s_running = true;
+    s_loop = &loop;
+    s_miscTimer = loop.addTimer(&MqttListener::onMiscTimer);
+    s_reconnectTimer = loop.addTimer(&MqttListener::onReconnectTimer);
+
+    std::cout << "[MqttListener] Connecting to " << s_host << ":" << s_port << "\n";
+
+    // _async: der Aufbau der TCP-Verbindung blockiert die EventLoop nicht (nur die Namensauflösung)
+    int rc = mosquitto_connect_async(s_mosq, s_host.c_str(), s_port, 60);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        lostConnection("mosquitto_connect()", rc);
+        return;
+    }
+    watchSocket();
+    loop.armTimer(s_miscTimer, kMiscMs, kMiscMs);
+}
+
+// Socket (neu) anmelden; EPOLLOUT nur, solange libmosquitto etwas zu senden hat
+void MqttListener::watchSocket()
+{
+    const int fd = mosquitto_socket(s_mosq);
+    uint32_t events = EPOLLIN;
+    if (mosquitto_want_write(s_mosq)) events |= EPOLLOUT;
+    if (fd != s_fd) {
+        if (s_fd >= 0) s_loop->remove(s_fd);
+        s_fd = fd;
+        if (s_fd >= 0) s_loop->add(s_fd, events, &MqttListener::onSocket);
+    } else if (s_fd >= 0) {
+        s_loop->modify(s_fd, events);
+    }
+}
+
+void MqttListener::onSocket(uint32_t events)
+{
+    int rc = MOSQ_ERR_SUCCESS;
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) rc = mosquitto_loop_read(s_mosq, 1);
+    if (rc == MOSQ_ERR_SUCCESS && (events & EPOLLOUT)) rc = mosquitto_loop_write(s_mosq, 1);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        lostConnection("mosquitto_loop()", rc);
+        return;
+    }
+    watchSocket();
+}
+
+// Keepalive (PINGREQ) und Timeouts; der Broker erwartet innerhalb von 1,5 × 60 s ein Paket
+void MqttListener::onMiscTimer()
+{
+    if (s_fd < 0) return;
+    int rc = mosquitto_loop_misc(s_mosq);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        lostConnection("mosquitto_loop_misc()", rc);
+        return;
+    }
+    watchSocket();
+}
+
+void MqttListener::onReconnectTimer()
+{
+    int rc = mosquitto_reconnect_async(s_mosq);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        lostConnection("reconnect", rc);
+        return;
+    }
+    watchSocket();
+}
+
+// Socket abmelden und später neu verbinden (2 s, bei weiteren Fehlschlägen bis 60 s)
+void MqttListener::lostConnection(const char* what, int rc)
+{
+    std::cerr << "[MqttListener] " << what << " failed: "
+              << mosquitto_strerror(rc) << " -> reconnect in " << s_reconnectMs << " ms\n";
+    if (s_fd >= 0) {
+        s_loop->remove(s_fd);
+        s_fd = -1;
+    }
+    s_loop->armTimer(s_reconnectTimer, s_reconnectMs);
+    s_reconnectMs = std::min(s_reconnectMs * 2, kReconnectMaxMs);
+}
+
 void MqttListener::threadFunc()
 {
     std::cout << "[MqttListener] Connecting to " << s_host << ":" << s_port << "\n";
@@ -116,6 +228,7 @@ void MqttListener::onConnect(struct mosquitto* /*mosq*/, void* /*userdata*/, int
 {
     std::cout << "[MqttListener] onConnect rc=" << rc << "\n";
     if (rc == 0) {
+        s_reconnectMs = kReconnectMinMs;
         std::cout << "[MqttListener] Subscribing to topic: " << s_topic << "\n";
         int subRc = mosquitto_subscribe(s_mosq, nullptr, s_topic.c_str(), 0);
         if (subRc != MOSQ_ERR_SUCCESS) {
@@ -147,25 +260,37 @@ void MqttListener::onMessage(struct mosquitto* /*mosq*/,
 
     // Nur die Talker-Events /server/statethr/.. in DB schreiben
     if (topic.rfind("/server/statethr", 0) == 0 && s_db) {
-        try {
-            json j = json::parse(payload);
-
-            std::string timeStr  = j.value("time",   "");
-            std::string talkStr  = j.value("talk",   "");
-            std::string callStr  = j.value("call",   "");
-            std::string tgStr    = j.value("tg",     "");
-            std::string srvStr   = j.value("server", "");
-
-            if (!timeStr.empty() && !talkStr.empty() && !callStr.empty() && !tgStr.empty()) {
-                if (!s_db->insertEvent(timeStr, talkStr, callStr, tgStr, srvStr)) {
-                    std::cerr << "[MqttListener] insertEvent failed\n";
-                }
-            } else {
-                std::cerr << "[MqttListener] JSON missing required fields\n";
+        TalkerEvent ev;
+        if (parseTalkerEvent(payload, ev)) {
+            if (s_pool) {
+                // Schreiben übernimmt die EventLoop, der MQTT-Thread wartet nicht auf den Server
+                FMDatabase::queueEvent(*s_pool, s_poolKey, ev.time, ev.talk, ev.call, ev.tg, ev.server);
+            } else if (!s_db->insertEvent(ev.time, ev.talk, ev.call, ev.tg, ev.server)) {
+                std::cerr << "[MqttListener] insertEvent failed\n";
             }
+        }
+    }
+}
+
+bool MqttListener::parseTalkerEvent(const std::string& payload, TalkerEvent& ev)
+{
+    try {
+        json j = json::parse(payload);
 
-        } catch (const std::exception& e) {
-            std::cerr << "[MqttListener] JSON parse error: " << e.what() << "\n";
+        ev.time   = j.value("time",   "");
+        ev.talk   = j.value("talk",   "");
+        ev.call   = j.value("call",   "");
+        ev.tg     = j.value("tg",     "");
+        ev.server = j.value("server", "");
+
+        if (ev.time.empty() || ev.talk.empty() || ev.call.empty() || ev.tg.empty()) {
+            std::cerr << "[MqttListener] JSON missing required fields\n";
+            return false;
         }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "[MqttListener] JSON parse error: " << e.what() << "\n";
+        return false;
     }
 }
@@ -4,9 +4,12 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <cstdint>
 #include <mosquitto.h>
 
 class FMDatabase; // forward
+class AsyncDbPool; // forward
+class EventLoop; // forward
 
 class MqttListener {
 public:
@@ -15,11 +18,32 @@ public:
     static void start();
     static void stop();
 
+    // Statt start(): kein eigener Thread, Socket und Keepalive laufen über die EventLoop.
+    // stop() muss dann vor dem Ende der EventLoop aufgerufen werden.
+    static void attach(EventLoop& loop);
+
+    // Events nicht blockierend über den Pool schreiben (Verbindung key); vor start() setzen
+    static void setAsyncDb(AsyncDbPool* pool, unsigned key);
+
+    // Talker-Event aus der JSON-Nutzlast von /server/statethr/..
+    struct TalkerEvent {
+        std::string time, talk, call, tg, server;
+    };
+    // false bei kaputtem JSON oder fehlenden Pflichtfeldern (Meldung auf stderr)
+    static bool parseTalkerEvent(const std::string& payload, TalkerEvent& ev);
+
 private:
     MqttListener() = delete;
 
     static void threadFunc();
 
+    // EventLoop-Betrieb
+    static void watchSocket();
+    static void onSocket(uint32_t events);
+    static void onMiscTimer();
+    static void onReconnectTimer();
+    static void lostConnection(const char* what, int rc);
+
     static void onConnect(struct mosquitto* mosq, void* userdata, int rc);
     static void onMessage(struct mosquitto* mosq, void* userdata, const struct mosquitto_message* msg);
 
@@ -33,6 +57,18 @@ private:
     static inline struct mosquitto*  s_mosq = nullptr;
     static inline std::atomic<bool>  s_initialized{false};
 
+    // EventLoop-Betrieb: mosquitto_loop_misc (Keepalive) und Wiederverbinden über Timer
+    static constexpr unsigned kMiscMs = 10000;
+    static constexpr unsigned kReconnectMinMs = 2000;
+    static constexpr unsigned kReconnectMaxMs = 60000;
+    static inline EventLoop*         s_loop = nullptr;
+    static inline int                s_fd = -1;
+    static inline int                s_miscTimer = -1;
+    static inline int                s_reconnectTimer = -1;
+    static inline unsigned           s_reconnectMs = kReconnectMinMs;
+
     // eigene DB-Instanz
     static inline FMDatabase*        s_db = nullptr;
+    static inline AsyncDbPool*       s_pool = nullptr;
+    static inline unsigned           s_poolKey = 0;
 };
@@ -0,0 +1,58 @@
+// StatusService.cpp
+#include "StatusService.h"
+
+#include <sys/epoll.h>
+
+#include "../StatusPipeline.h"
+
+using status::Database;
+using status::LocalConfig;
+using status::StatusOptions;
+using status::StatusTail;
+
+struct StatusService::Impl {
+    Impl(EventLoop& l, const StatusOptions& opt)
+        : loop(l), cfg(status::readLocalConfig()), tail(cfg, database, opt) {}
+
+    EventLoop& loop;
+    LocalConfig cfg;
+    Database database;
+    StatusTail tail;
+    int timer = -1;
+
+    // Einmal lesen; danach weckt eine Dateiänderung (inotify) oder der Timer (Merger, Polling)
+    void tick() {
+        const int timeoutMs = tail.tick();
+        loop.armTimer(timer, timeoutMs < 0 ? 0 : static_cast<unsigned>(std::max(1, timeoutMs)));
+    }
+};
+
+bool StatusService::checkArgs(int argc, char** argv, int first)
+{
+    const StatusOptions opt = status::parseStatusOptions(argc, argv, first);
+    if (opt.error.empty()) return true;
+    status::printStatusUsage("DVconfig --with-status", opt.error);
+    return false;
+}
+
+StatusService::StatusService(EventLoop& loop, int argc, char** argv, int first)
+{
+    const StatusOptions opt = status::parseStatusOptions(argc, argv, first);
+    if (!opt.importDir.empty() || !opt.replayFile.empty())
+        status::dlog("[STAT] --import/--replay only with mmdvm-status, ignored");
+
+    impl_ = std::make_unique<Impl>(loop, opt);
+    Impl* impl = impl_.get();
+    impl->timer = loop.addTimer([impl] { impl->tick(); });
+    if (impl->tail.watcher().ok())
+        loop.add(impl->tail.watcher().fd(), EPOLLIN, [impl](uint32_t) {
+            if (impl->tail.watcher().drain()) impl->tick();
+        });
+    impl->tick();
+}
+
+StatusService::~StatusService()
+{
+    if (impl_->tail.watcher().ok()) impl_->loop.remove(impl_->tail.watcher().fd());
+    impl_->loop.removeTimer(impl_->timer);
+}
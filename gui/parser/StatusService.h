@@ -0,0 +1,28 @@
+// StatusService.h
+#pragma once
+
+#include <memory>
+
+#include "EventLoop.h"
+
+/**
+ * Die Log-Auswertung von mmdvm-status im Prozess von DVconfig (DVconfig --with-status ...).
+ * Getrieben vom inotify-Deskriptor und einem Timer der EventLoop statt einer eigenen
+ * Schleife; die Datenbank schreibt wie im eigenständigen Dienst der DbWriter-Thread.
+ * Argumente wie bei mmdvm-status: Logpfade/Verzeichnisse, --reorder-ms, --spool-mb.
+ */
+class StatusService {
+public:
+    StatusService(EventLoop& loop, int argc, char** argv, int first);
+
+    // Prüft die Argumente ab first vor dem Start; bei unbekannter Option Aufruf nach stderr
+    static bool checkArgs(int argc, char** argv, int first);
+    ~StatusService();
+
+    StatusService(const StatusService&) = delete;
+    StatusService& operator=(const StatusService&) = delete;
+
+private:
+    struct Impl;                    // Typen aus StatusPipeline.h bleiben in StatusService.cpp
+    std::unique_ptr<Impl> impl_;
+};
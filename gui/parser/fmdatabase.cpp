@@ -1,5 +1,6 @@
 // fmdatabase.cpp
 #include "fmdatabase.h"
+#include "AsyncDb.h"
 
 #include <cstdio>
 #include <cstring>
@@ -7,9 +8,23 @@
 #include <sstream>
 #include <iomanip>
 
-FMDatabase::FMDatabase()
+static DbConn::Settings fmSettings(const std::string& unixSocket)
 {
-    if (!connect()) {
+    DbConn::Settings s;
+    s.unixSocket = unixSocket;
+    s.tag = "[FMDB]";
+    return s;
+}
+
+FMDatabase::FMDatabase(const std::string& unixSocket)
+    : db_(fmSettings(unixSocket))
+{
+    db_.onConnect([this](MYSQL* c) { return onConnect(c); });
+    db_.onClose([this] { conn_ = nullptr; });
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!db_.get()) {
+        lastError_ = db_.lastError();
         std::fprintf(stderr, "[FMDB] initial connect() failed: %s\n", lastError_.c_str());
     }
 }
@@ -17,56 +32,25 @@ FMDatabase::FMDatabase()
 FMDatabase::~FMDatabase()
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    if (conn_) {
-        mysql_close(conn_);
-        conn_ = nullptr;
-    }
+    db_.close();
 }
 
-bool FMDatabase::connect() noexcept
+void FMDatabase::release()
 {
     std::lock_guard<std::mutex> lock(mtx_);
+    db_.close();
+}
 
-    lastError_.clear();
-
-    if (conn_) {
-        mysql_close(conn_);
-        conn_ = nullptr;
-    }
-
-    conn_ = mysql_init(nullptr);
-    if (!conn_) {
-        lastError_ = "mysql_init failed";
-        std::fprintf(stderr, "[FMDB] %s\n", lastError_.c_str());
-        return false;
-    }
-
-    // Auto-Reconnect
-    {
-        bool rc = true;
-        mysql_options(conn_, MYSQL_OPT_RECONNECT, &rc);
-    }
-
-    // Unix-Socket forcieren (optional)
-    {
-        unsigned int proto = MYSQL_PROTOCOL_SOCKET;
-        mysql_options(conn_, MYSQL_OPT_PROTOCOL, &proto);
-    }
+std::string FMDatabase::countersText()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return db_.countersText();
+}
 
-    if (!mysql_real_connect(conn_,
-                            nullptr,                   // host (nullptr = lokal)
-                            dbUser_.c_str(),
-                            dbPass_.c_str(),
-                            dbName_.c_str(),
-                            dbPort_,
-                            dbUnixSocket_.c_str(),
-                            0)) {
-        lastError_ = mysql_error(conn_);
-        std::fprintf(stderr, "[FMDB] mysql_real_connect failed: %s\n", lastError_.c_str());
-        mysql_close(conn_);
-        conn_ = nullptr;
-        return false;
-    }
+bool FMDatabase::onConnect(MYSQL* c) noexcept
+{
+    lastError_.clear();
+    conn_ = c;
 
     if (!ensureSchema()) {
         std::fprintf(stderr, "[FMDB] ensureSchema failed: %s\n", lastError_.c_str());
@@ -125,20 +109,6 @@ bool FMDatabase::ensureSchema() noexcept
     return true;
 }
 
-bool FMDatabase::ensureConn() noexcept
-{
-    std::lock_guard<std::mutex> lock(mtx_);
-
-    if (!conn_) {
-        return connect();
-    }
-
-    if (mysql_ping(conn_) == 0) return true;
-
-    std::fprintf(stderr, "[FMDB] ping failed: %s -> reconnect\n", mysql_error(conn_));
-    return connect();
-}
-
 std::string FMDatabase::escape(const std::string& in) noexcept
 {
     if (!conn_) return std::string();
@@ -169,11 +139,72 @@ std::string FMDatabase::makeDateTime(const std::string& timeStr) noexcept
     return oss.str();
 }
 
+const char* const FMDatabase::kCountSql = "SELECT COUNT(*) FROM fmlastheard";
+
+// alles löschen, was seit > 3 Minuten nicht aktualisiert wurde
+const char* const FMDatabase::kCleanupSql =
+    "DELETE FROM fmstatus "
+    "WHERE last_update < (NOW() - INTERVAL 3 MINUTE)";
+
+std::string FMDatabase::pruneSql(unsigned long long cnt)
+{
+    if (cnt <= MAX_ROWS_) return std::string();
+
+    std::ostringstream oss;
+    oss << "DELETE FROM fmlastheard ORDER BY event_time ASC LIMIT " << (cnt - MAX_ROWS_);
+    return oss.str();
+}
+
+FMDatabase::EventSql FMDatabase::eventSql(const std::string& timeStr,
+                                          const std::string& talk,
+                                          const std::string& call,
+                                          const std::string& tg,
+                                          const std::string& server,
+                                          const std::function<std::string(const std::string&)>& esc)
+{
+    std::string dtE    = esc(makeDateTime(timeStr));
+    std::string talkE  = esc(talk);
+    std::string callE  = esc(call);
+    std::string srvE   = esc(server);
+
+    int tgInt = 0;
+    try {
+        tgInt = std::stoi(tg);
+    } catch (...) {
+        tgInt = 0;
+    }
+
+    EventSql sql;
+    std::ostringstream oss;
+    oss << "INSERT INTO fmlastheard (event_time, talk, callsign, tg, server) VALUES ("
+        << "'" << dtE          << "',"
+        << "'" << talkE        << "',"
+        << "'" << callE        << "',"
+        <<      tgInt          << ","
+        << "'" << srvE         << "')";
+    sql.insert = oss.str();
+
+    // fmstatus pflegen: start -> eintragen/aktualisieren, stop -> löschen
+    if (talk == "start") {
+        // REPLACE INTO -> callsign ist PRIMARY KEY, also immer max. 1 Zeile pro Callsign
+        std::ostringstream st;
+        st << "REPLACE INTO fmstatus (callsign, event_time, tg, server) VALUES ("
+           << "'" << callE << "',"
+           << "'" << dtE   << "',"
+           <<      tgInt   << ","
+           << "'" << srvE  << "')";
+        sql.status = st.str();
+    } else if (talk == "stop") {
+        sql.status = "DELETE FROM fmstatus WHERE callsign='" + callE + "'";
+    }
+    return sql;
+}
+
 bool FMDatabase::pruneIfNeeded() noexcept
 {
     if (!conn_) return false;
 
-    if (mysql_query(conn_, "SELECT COUNT(*) FROM fmlastheard") != 0) {
+    if (mysql_query(conn_, kCountSql) != 0) {
         lastError_ = mysql_error(conn_);
         std::fprintf(stderr, "[FMDB] COUNT(*) failed: %s\n", lastError_.c_str());
         return false;
@@ -190,16 +221,12 @@ bool FMDatabase::pruneIfNeeded() noexcept
     unsigned long long cnt = (row && row[0]) ? std::strtoull(row[0], nullptr, 10) : 0ULL;
     mysql_free_result(res);
 
-    if (cnt <= MAX_ROWS_) {
+    const std::string del = pruneSql(cnt);
+    if (del.empty()) {
         return true;
     }
 
-    unsigned long long toDelete = cnt - MAX_ROWS_;
-
-    std::ostringstream oss;
-    oss << "DELETE FROM fmlastheard ORDER BY event_time ASC LIMIT " << toDelete;
-
-    if (mysql_query(conn_, oss.str().c_str()) != 0) {
+    if (mysql_query(conn_, del.c_str()) != 0) {
         lastError_ = mysql_error(conn_);
         std::fprintf(stderr, "[FMDB] prune DELETE failed: %s\n", lastError_.c_str());
         return false;
@@ -208,56 +235,11 @@ bool FMDatabase::pruneIfNeeded() noexcept
     return true;
 }
 
-// fmstatus pflegen: start -> eintragen/aktualisieren, stop -> löschen
-bool FMDatabase::updateStatus(const std::string& dt,
-                              const std::string& talk,
-                              const std::string& call,
-                              int tg,
-                              const std::string& server) noexcept
-{
-    if (!conn_) return false;
-
-    // nur start/stop relevant
-    if (talk == "start") {
-        std::string callE = escape(call);
-        std::string srvE  = escape(server);
-        std::string dtE   = escape(dt);
-
-        // REPLACE INTO -> callsign ist PRIMARY KEY, also immer max. 1 Zeile pro Callsign
-        std::ostringstream oss;
-        oss << "REPLACE INTO fmstatus (callsign, event_time, tg, server) VALUES ("
-            << "'" << callE << "',"
-            << "'" << dtE   << "',"
-            <<      tg      << ","
-            << "'" << srvE  << "')";
-        if (mysql_query(conn_, oss.str().c_str()) != 0) {
-            lastError_ = mysql_error(conn_);
-            std::fprintf(stderr, "[FMDB] updateStatus REPLACE failed: %s\n", lastError_.c_str());
-            return false;
-        }
-    } else if (talk == "stop") {
-        std::string callE = escape(call);
-        std::string q = "DELETE FROM fmstatus WHERE callsign='" + callE + "'";
-        if (mysql_query(conn_, q.c_str()) != 0) {
-            lastError_ = mysql_error(conn_);
-            std::fprintf(stderr, "[FMDB] updateStatus DELETE failed: %s\n", lastError_.c_str());
-            return false;
-        }
-    }
-
-    return true;
-}
-
-// alles löschen, was seit > 3 Minuten nicht aktualisiert wurde
 bool FMDatabase::cleanupStatus() noexcept
 {
     if (!conn_) return false;
 
-    static const char* q =
-        "DELETE FROM fmstatus "
-        "WHERE last_update < (NOW() - INTERVAL 3 MINUTE)";
-
-    if (mysql_query(conn_, q) != 0) {
+    if (mysql_query(conn_, kCleanupSql) != 0) {
         lastError_ = mysql_error(conn_);
         std::fprintf(stderr, "[FMDB] cleanupStatus failed: %s\n", lastError_.c_str());
         return false;
@@ -271,54 +253,72 @@ bool FMDatabase::insertEvent(const std::string& timeStr,
                              const std::string& tg,
                              const std::string& server) noexcept
 {
-    if (!ensureConn()) {
-        std::fprintf(stderr, "[FMDB] insertEvent: no connection: %s\n", lastError_.c_str());
-        return false;
-    }
-
     std::lock_guard<std::mutex> lock(mtx_);
-
-    std::string dt     = makeDateTime(timeStr);
-    std::string talkE  = escape(talk);
-    std::string callE  = escape(call);
-    std::string srvE   = escape(server);
-
-    int tgInt = 0;
-    try {
-        tgInt = std::stoi(tg);
-    } catch (...) {
-        tgInt = 0;
-    }
-
-    std::ostringstream oss;
-    oss << "INSERT INTO fmlastheard (event_time, talk, callsign, tg, server) VALUES ("
-        << "'" << escape(dt)   << "',"
-        << "'" << talkE        << "',"
-        << "'" << callE        << "',"
-        <<      tgInt          << ","
-        << "'" << srvE         << "')";
-    
-    if (mysql_query(conn_, oss.str().c_str()) != 0) {
-        lastError_ = mysql_error(conn_);
-        std::fprintf(stderr, "[FMDB] INSERT fmlastheard failed: %s\n", lastError_.c_str());
+    std::string status;
+
+    // War die Verbindung schon weg, wiederholt DbConn das Statement einmal auf der neuen
+    // Verbindung; bricht sie währenddessen ab (CR_SERVER_LOST), nicht, sonst droht eine Doppelzeile
+    const DbConn::Result r = db_.run([&](MYSQL* c) {
+        const EventSql sql = eventSql(timeStr, talk, call, tg, server,
+                                      [this](const std::string& v) { return escape(v); });
+        if (mysql_query(c, sql.insert.c_str()) != 0) {
+            lastError_ = mysql_error(c);
+            std::fprintf(stderr, "[FMDB] INSERT fmlastheard failed: %s\n", lastError_.c_str());
+            return false;
+        }
+        status = sql.status;
+        return true;
+    });
+    if (r != DbConn::Result::Ok) {
+        if (r == DbConn::Result::Down) {
+            lastError_ = db_.lastError();
+            std::fprintf(stderr, "[FMDB] insertEvent: no connection: %s\n", lastError_.c_str());
+        }
         return false;
     }
 
     // fmstatus für "start"/"stop" pflegen
-    if (!updateStatus(dt, talk, call, tgInt, server)) {
-        std::fprintf(stderr, "[FMDB] updateStatus failed: %s\n", lastError_.c_str());
+    if (!status.empty()) {
+        const DbConn::Result rs = db_.run([&](MYSQL* c) { return mysql_query(c, status.c_str()) == 0; });
+        if (rs == DbConn::Result::Error) {
+            lastError_ = mysql_error(conn_);
+            std::fprintf(stderr, "[FMDB] updateStatus failed: %s\n", lastError_.c_str());
+        }
         // kein harter Fehler für insertEvent
     }
 
     // fmlastheard begrenzen
-    if (!pruneIfNeeded()) {
+    if (db_.run([this](MYSQL*) { return pruneIfNeeded(); }) != DbConn::Result::Ok) {
         std::fprintf(stderr, "[FMDB] pruneIfNeeded failed: %s\n", lastError_.c_str());
     }
 
     // fmstatus Timeout (alles, was > 3min alt ist, entfernen)
-    if (!cleanupStatus()) {
+    if (db_.run([this](MYSQL*) { return cleanupStatus(); }) != DbConn::Result::Ok) {
         std::fprintf(stderr, "[FMDB] cleanupStatus failed: %s\n", lastError_.c_str());
     }
 
     return true;
 }
+
+void FMDatabase::queueEvent(AsyncDbPool& pool, unsigned key,
+                            const std::string& timeStr,
+                            const std::string& talk,
+                            const std::string& call,
+                            const std::string& tg,
+                            const std::string& server)
+{
+    const EventSql sql = eventSql(timeStr, talk, call, tg, server, &AsyncDb::escape);
+
+    // Wie insertEvent: ohne INSERT keine weiteren Statements (Fehlermeldung kommt von AsyncDb)
+    pool.query(key, sql.insert, [&pool, key, status = sql.status](MYSQL_RES*, const char* error) {
+        if (error) return;
+        if (!status.empty()) pool.query(key, status);
+        pool.query(key, kCountSql, [&pool, key](MYSQL_RES* res, const char* err) {
+            if (err || !res) return;
+            MYSQL_ROW row = mysql_fetch_row(res);
+            const std::string del = pruneSql((row && row[0]) ? std::strtoull(row[0], nullptr, 10) : 0ULL);
+            if (!del.empty()) pool.query(key, del);
+        });
+        pool.query(key, kCleanupSql);
+    });
+}
@@ -4,15 +4,26 @@
 #include <string>
 #include <mysql/mysql.h>
 #include <mutex>
+#include <functional>
+#include "../DbConn.h"
+
+class AsyncDbPool; // forward
 
 class FMDatabase {
 public:
-    FMDatabase();
+    // unixSocket: Pfad zum Socket des MariaDB-Servers (Benchmark mit Wegwerf-Instanz)
+    explicit FMDatabase(const std::string& unixSocket = "/run/mysqld/mysqld.sock");
     ~FMDatabase();
 
     FMDatabase(const FMDatabase&) = delete;
     FMDatabase& operator=(const FMDatabase&) = delete;
 
+    // Pings, Wiederverbindungen, Wiederholungen
+    std::string countersText();
+
+    // Verbindung schließen (Schreiben läuft über AsyncDbPool); insertEvent verbindet bei Bedarf neu
+    void release();
+
     // Ein einzelnes MQTT-Event eintragen + fmstatus pflegen
     bool insertEvent(const std::string& timeStr,
                      const std::string& talk,
@@ -20,38 +31,50 @@ public:
                      const std::string& tg,
                      const std::string& server) noexcept;
 
+    // Dasselbe nicht blockierend: die Statements laufen in Reihenfolge auf der Verbindung key
+    // des Pools (aus jedem Thread aufrufbar). Das Schema legt vorher der Konstruktor an.
+    static void queueEvent(AsyncDbPool& pool, unsigned key,
+                           const std::string& timeStr,
+                           const std::string& talk,
+                           const std::string& call,
+                           const std::string& tg,
+                           const std::string& server);
+
 private:
-    bool connect() noexcept;
+    // SQL für INSERT fmlastheard und die fmstatus-Pflege (leer, wenn weder start noch stop)
+    struct EventSql {
+        std::string insert;
+        std::string status;
+    };
+    static EventSql eventSql(const std::string& timeStr,
+                             const std::string& talk,
+                             const std::string& call,
+                             const std::string& tg,
+                             const std::string& server,
+                             const std::function<std::string(const std::string&)>& esc);
+    static std::string pruneSql(unsigned long long cnt);
+    static const char* const kCountSql;
+    static const char* const kCleanupSql;
+
+    // nach jedem (Wieder-)Verbinden durch DbConn
+    bool onConnect(MYSQL* c) noexcept;
     bool ensureSchema() noexcept;
-    bool ensureConn() noexcept;
 
     // fmlastheard begrenzen
     bool pruneIfNeeded() noexcept;
 
-    // fmstatus: aktive Stationen pflegen
-    bool updateStatus(const std::string& dt,
-                      const std::string& talk,
-                      const std::string& call,
-                      int tg,
-                      const std::string& server) noexcept;
-
     // Einträge, die länger als 3 Minuten nicht aktualisiert wurden, löschen
     bool cleanupStatus() noexcept;
 
     // Hilfsfunktionen
-    std::string makeDateTime(const std::string& timeStr) noexcept;
+    static std::string makeDateTime(const std::string& timeStr) noexcept;
     std::string escape(const std::string& in) noexcept;
 
-    MYSQL* conn_ = nullptr;
-    std::string lastError_;
-
-    std::mutex mtx_;
+    std::mutex mtx_;            // schützt db_ und conn_
 
-    const std::string dbUser_       = "mmdvm";       // <- ändern
-    const std::string dbPass_       = "";                 // <- ändern
-    const std::string dbName_       = "mmdvmdb";         // <- ändern
-    const std::string dbUnixSocket_ = "/run/mysqld/mysqld.sock"; // <- ggf. ändern
-    const unsigned int dbPort_      = 0; // 0 = über Unix-Socket
+    DbConn db_;                 // Benutzer/DB-Name: DbConn::Settings
+    MYSQL* conn_ = nullptr;     // aktuelle Verbindung, nur zwischen onConnect und close gültig
+    std::string lastError_;
 
     static constexpr unsigned long MAX_ROWS_ = 5000;      // Limit fmlastheard
 };
@@ -1,41 +1,126 @@
-#include <thread>
-#include <chrono>
+#include <cstdio>
 #include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
 #include "handleDVconfig.h"
 #include "Database.h"
 #include "MqttListener.h"
+#include "EventLoop.h"
+#include "AsyncDb.h"
+#include "StatusService.h"
+#include "ConfigNotify.h"
 
 static std::atomic<bool> g_running{true};
+static EventLoop* g_loop = nullptr;
+
+// Verbindungen im Pool: config_inbox und FM-Events warten nicht aufeinander
+static constexpr unsigned kConfigKey = 0;
+static constexpr unsigned kFmKey     = 1;
+
+// config_inbox: Abfrage ohne Weckruf-Socket wie bisher, mit Socket nur noch zur Sicherheit
+static constexpr unsigned kPollMs         = 100;
+static constexpr unsigned kFallbackPollMs = 30000;
 
 void sigHandler(int)
 {
     g_running = false;
-    MqttListener::stop();
+    if (g_loop) g_loop->stop();
 }
 
-int main(){
+// Resident Set Size aus /proc/self/status in kB (0, wenn nicht lesbar)
+static long rssKb()
+{
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    while (std::getline(f, line))
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::atol(line.c_str() + 6);
+    return 0;
+}
+
+// DVconfig [--with-status [Logpfade...] [--reorder-ms N] [--spool-mb N]]
+//   --with-status: die Log-Auswertung von mmdvm-status läuft im selben Prozess und an derselben
+//   EventLoop mit (mmdvm-status.service dann nicht zusätzlich starten)
+int main(int argc, char** argv){
+    int statusArgs = 0;
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--with-status") == 0) { statusArgs = i + 1; break; }
+    if (statusArgs && !StatusService::checkArgs(argc, argv, statusArgs)) return 2;
+
     // Nach dem Programmstart fülle die Datenbank einmalig
     handleDVconfig dv;
     dv.readConfig();           // fills dv.site
-    Database db;
-    db.writeSiteData(dv.site); // push to DB (id=1)
+    {
+        Database db;
+        db.writeSiteData(dv.site); // push to DB (id=1), legt auch das Schema an
+    }
+
+    // Alle weiteren DB-Zugriffe laufen nicht blockierend über die EventLoop
+    EventLoop loop;
+    g_loop = &loop;
+    AsyncDbPool pool(loop, 2);
 
-    // Starte FM Funknetz Abfragen als Thread
+    // FM Funknetz: Socket und Keepalive an der EventLoop, kein eigener Thread
     MqttListener::init();
+    MqttListener::setAsyncDb(&pool, kFmKey);
     std::signal(SIGINT,  sigHandler);
     std::signal(SIGTERM, sigHandler);
-    MqttListener::start();
-
-    // führe DV Logfile Parsing in dieser Loop aus
-    while(g_running) {
-        bool newdata = db.readSiteData(dv.site);
-        if(newdata) {
-            // handle data
-            printf("new data from GUI\n");
-            dv.saveConfig();
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    MqttListener::attach(loop);
+
+    std::unique_ptr<StatusService> status;
+    if (statusArgs) status = std::make_unique<StatusService>(loop, argc, argv, statusArgs);
+
+    // config_inbox lesen, wenn save_config.php über ConfigNotify weckt; die langsame Abfrage
+    // fängt verlorene Weckrufe ab. Kommt ein Weckruf während einer laufenden Abfrage, folgt
+    // direkt danach eine weitere – die Änderung kann nach deren SELECT geschrieben worden sein.
+    bool polling = false;
+    bool again = false;
+    std::function<void()> checkInbox = [&] {
+        if (polling) { again = true; return; }
+        polling = true;
+        again = false;
+        auto done = [&] {
+            polling = false;
+            if (again) checkInbox();
+        };
+        pool.query(kConfigKey, Database::kSelectSiteData, [&, done](MYSQL_RES* res, const char* error) {
+            if (error || !res || !Database::parseSiteData(res, dv.site)) {
+                done();
+                return;
+            }
+            // erst quittieren, dann anwenden – wie readSiteData
+            pool.query(kConfigKey, Database::kSetIdle, [&, done](MYSQL_RES*, const char* err) {
+                if (!err) {
+                    printf("new data from GUI\n");
+                    dv.saveConfig();
+                }
+                done();
+            });
+        });
+    };
+    ConfigNotify notify(loop, checkInbox);
+    const unsigned pollMs = notify.ok() ? kFallbackPollMs : kPollMs;
+    if (!notify.ok()) std::fprintf(stderr, "[NOTIFY] no socket, polling config_inbox every %u ms\n", pollMs);
+    const int pollTimer = loop.addTimer([&] { checkInbox(); });
+    loop.armTimer(pollTimer, 1, pollMs); // einmal gleich nach dem Start: Änderungen aus der Zeit davor
+
+    const auto started = std::chrono::steady_clock::now();
+    if (g_running) loop.run();
+
+    // Ruhelast: Aufwachvorgänge der EventLoop (ohne DbWriter-Thread) und Speicherbedarf
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::fprintf(stderr, "[LOOP] wakeups=%llu in %.0f s (%.2f/s) rss=%ld kB\n",
+                 static_cast<unsigned long long>(loop.wakeups()), secs,
+                 secs > 0 ? loop.wakeups() / secs : 0.0, rssKb());
+    std::fprintf(stderr, "[ADB] config_inbox %s\n", pool.countersText(kConfigKey).c_str());
+
+    status.reset();
+    MqttListener::stop();
+    g_loop = nullptr;
     return 0;
 }
@@ -129,7 +129,7 @@ base_packages() {
     git build-essential cmake libusb-1.0-0-dev \
     libasound2-dev libfftw3-dev libgps-dev \
     libwxgtk3.2-dev logrotate curl ca-certificates \
-    libmariadb-dev libmariadb-dev-compat mariadb-server \
+    libmariadb-dev libmariadb-dev-compat mariadb-server zlib1g-dev \
     apache2 php libapache2-mod-php php-mysql wget php-curl
   apt-get autoremove -y || true
   apt-get clean || true